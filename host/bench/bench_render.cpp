@@ -0,0 +1,274 @@
+// ============== Native render benchmark ==============
+// Builds src/main.cpp against host/shim and times each renderer on a Linux
+// box with scripted band input (120 BPM kick, 8th-note hats, drifting mids).
+//
+//   pio run -e native && .pio/build/native/program [--frames N] [--csv] [--only NAME] [--threads 2]
+//
+// Virtual time advances 1/60 s per frame, so every run sees the same inputs;
+// only the wall-clock cost differs between commits. --threads 2 runs each
+// case a second time with the per-strip work forked onto a worker thread
+// (stripFork, as on the two cores) and adds its mean and the speedup.
+//
+// "passes" is full-strip buffer passes per frame spent on overlays: the
+// stack/ cases run the same flash/strobe/dim/blackout layers once the old
+// way (base render, then one pass per layer per strip) and once through the
+// compositor (opaque stacks skip the base, the rest fuse into one pass).
+
+#include "../../src/main.cpp"   // single TU: the bench pokes main.cpp's statics
+#include "fake_msgeq7.h"
+#include "scripted_bands.h"
+
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <algorithm>
+
+// ---- allocation counter ----
+// Every global new/delete form goes through one out-of-line pair, so
+// allocation and release always match (and the compiler never sees a
+// replaced operator new's pointer reach free() directly).
+static uint64_t g_allocs = 0;
+
+[[gnu::noinline]] static void* countedAlloc(size_t n, size_t align) {
+  ++g_allocs;
+  if (!n) n = 1;
+  void* p = align > alignof(std::max_align_t) ? aligned_alloc(align, (n + align - 1) / align * align) : malloc(n);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+[[gnu::noinline]] static void countedFree(void* p) noexcept { free(p); }
+
+void* operator new(size_t n)                           { return countedAlloc(n, 0); }
+void* operator new[](size_t n)                         { return countedAlloc(n, 0); }
+void* operator new(size_t n, std::align_val_t a)       { return countedAlloc(n, (size_t)a); }
+void* operator new[](size_t n, std::align_val_t a)     { return countedAlloc(n, (size_t)a); }
+void  operator delete(void* p) noexcept                { countedFree(p); }
+void  operator delete[](void* p) noexcept              { countedFree(p); }
+void  operator delete(void* p, size_t) noexcept        { countedFree(p); }
+void  operator delete[](void* p, size_t) noexcept      { countedFree(p); }
+void  operator delete(void* p, std::align_val_t) noexcept           { countedFree(p); }
+void  operator delete[](void* p, std::align_val_t) noexcept         { countedFree(p); }
+void  operator delete(void* p, size_t, std::align_val_t) noexcept   { countedFree(p); }
+void  operator delete[](void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+
+static const uint32_t FRAME_US   = 16667;   // 60 FPS virtual clock
+static const uint32_t START_US   = 1000000;
+static const int      WARMUP     = 60;
+
+static uint64_t g_legacyPasses = 0;         // strip passes of the .../legacy stack cases
+
+// ---- scene reset so each case starts from the same state ----
+static void resetScene(uint8_t paletteIdx) {
+  hostSetMicros(START_US);
+  frameClock.reset(micros(), millis());
+  seedEffects(1337);
+  segments.clear();
+  memset(pulses1, 0, sizeof(pulses1));
+  memset(pulses2, 0, sizeof(pulses2));
+  lastBassHitMs = lastTrebleHitMs = 0;
+  g_sceneLevel = 0.0f;
+  currentMode = FX_MODE;
+  strobeActive = strobeFromKey = blackoutActive = flashHeldTouch = false;
+  flashPulseUntil = 0;
+  flashLevel = blackoutLevel = 0;
+  laserDim = laserDimTarget = 255;
+  setMusicPalette(paletteIdx, 0, true);
+}
+
+// ---- cases ----
+struct BenchCase {
+  const char* name;
+  uint8_t paletteIdx;
+  void (*prep)(uint32_t frame);   // untimed per-frame setup
+  void (*run)();                  // timed
+};
+
+static void prepBands(uint32_t) { scriptBands(millis()); }
+
+static void prepSegments(uint32_t frame) {
+  scriptBands(millis());
+  if (frame % 4 == 0) {   // keep the pool saturated
+    bool bass = (frame / 4) & 1;
+    spawnSegmentStrong((int)(frame * 37) % NUM_LEDS, bass ? BASS_SEG_LEN : TREB_SEG_LEN, bass, 230);
+  }
+}
+
+static void prepSegmentsDense(uint32_t frame) {
+  scriptBands(millis());
+  for (int k = 0; k < 2; k++) {   // drum roll on both lanes: pool stays full
+    bool bass = k == 0;
+    spawnSegmentStrong((int)(frame * 37 + k * 300) % NUM_LEDS, bass ? BASS_SEG_LEN : TREB_SEG_LEN, bass, 230);
+  }
+}
+
+static void prepPulses(uint32_t frame) {
+  if (frame % 10 == 0) {  // same burst a Bounce 'K' jolt spawns
+    int h = (int)(frame * 13) % NUM_LEDS;
+    spawnStaticPulse(true,  h, true);  spawnStaticPulse(true,  h, false);
+    spawnStaticPulse(false, h, false); spawnStaticPulse(false, h, true);
+  }
+}
+
+// Whole loop() in Music mode: the MSGEQ7 engine is ticked (untimed) through
+// the frame against the fake chip, as the hardware timer would.
+static FakeMsgeq7 g_chip;
+
+static void prepLoop(uint32_t frame) {
+  if (frame == 0) currentMode = MUSIC_MODE;
+  uint64_t end = g_hostMicros;
+  for (uint64_t t = end - FRAME_US; t < end; t += MSGEQ7_TICK_US) {
+    hostSetMicros(t);
+    uint8_t lv[7];
+    scriptLevels(millis(), lv);
+    for (int b = 0; b < 7; b++) g_chip.level[b] = (uint16_t)(lv[b] * 16);
+    msgeq7.tick();
+  }
+  hostSetMicros(end);
+}
+
+// Overlay stacks over paletteFlow. The flash pulses every half second and
+// decays through translucent levels; dim is held at a laser-on level.
+static void prepFlashDim(uint32_t frame) {
+  scriptBands(millis());
+  if (frame % 30 == 0) flashPulseUntil = millis() + 1;
+  laserDim = laserDimTarget = 96;
+}
+static void prepStrobeFlashDim(uint32_t frame) { prepFlashDim(frame); strobeFromKey = true; }
+static void prepBlackout(uint32_t)             { scriptBands(millis()); blackoutActive = true; }
+static void prepLoopStrobe(uint32_t frame)     { prepLoop(frame); strobeFromKey = true; }
+
+// What loop() did before the compositor: always render, then every layer
+// as its own pass over each strip.
+static void runStackLegacy() {
+  buildOverlayLayers();
+  fx_paletteFlow();
+  for (uint8_t i = 0; i < overlay.count(); i++) {
+    const Layer& l = overlay.layer(i);
+    Compositor one;                                     // the layer's own tight loop (or fill)
+    one.add(l.mode, l.opacity, l.color[0], l.color[1]);
+    one.apply(leds1, NUM_LEDS, 0);
+    one.apply(leds2, NUM_LEDS, 1);
+    g_legacyPasses += 2;
+  }
+}
+// The same frame as loop() now composes it.
+static void runStackComposed() {
+  buildOverlayLayers();
+  if (!overlay.coversBase()) fx_paletteFlow();
+  overlay.apply(leds1, NUM_LEDS, 0);
+  overlay.apply(leds2, NUM_LEDS, 1);
+}
+
+static void runCloudsPair() {
+  static uint16_t t = 0;
+  t += 3;
+  const CloudsJob job(paletteLut(), BRIGHTNESS, 1.0f, cloudsDt(), frameClock.ms(),
+                      { t, (uint16_t)(t * 2), (uint16_t)(t * 3) },
+                      { (uint16_t)-t, (uint16_t)(-t * 2), (uint16_t)(-t * 3) });
+  renderCloudsPair(job);
+}
+static void runOverlay() { addSegmentOverlay(); }
+static void runPulses()  { renderStaticPulses(pulses1, leds1); renderStaticPulses(pulses2, leds2); }
+
+static const BenchCase CASES[] = {
+  { "paletteFlow",         1, prepBands,    fx_paletteFlow },
+  { "paletteFlow/Dark",    DARK_PALETTE_INDEX, prepBands, fx_paletteFlow },
+  { "renderPaletteClouds", 1, prepBands,    runCloudsPair },
+  { "addSegmentOverlay",   1, prepSegments, runOverlay },
+  { "addSegmentOverlay/dense", 1, prepSegmentsDense, runOverlay },
+  { "addSegmentOverlay/dense/Dark", DARK_PALETTE_INDEX, prepSegmentsDense, runOverlay },
+  { "renderStaticPulses",  1, prepPulses,   runPulses },
+  { "fx/Confetti",         1, prepBands,    fx_confetti },
+  { "fx/Bounce",           1, prepBands,    fx_bounce },
+  { "fx/Rainbow",          1, prepBands,    fx_rainbow },
+  { "fx/DJ Segments",      1, prepSegments, fx_segmentDJ },
+  { "loop/Music",          1, prepLoop,     loop },
+  { "loop/Music+strobe",   1, prepLoopStrobe, loop },
+  { "stack/flash+dim/legacy",        1, prepFlashDim,       runStackLegacy },
+  { "stack/flash+dim",               1, prepFlashDim,       runStackComposed },
+  { "stack/strobe+flash+dim/legacy", 1, prepStrobeFlashDim, runStackLegacy },
+  { "stack/strobe+flash+dim",        1, prepStrobeFlashDim, runStackComposed },
+  { "stack/blackout/legacy",         1, prepBlackout,       runStackLegacy },
+  { "stack/blackout",                1, prepBlackout,       runStackComposed },
+};
+
+struct Stats { double mean, p50, p99, max, allocsPerFrame, passesPerFrame; };
+
+static Stats runCase(const BenchCase& c, int frames) {
+  resetScene(c.paletteIdx);
+  std::vector<double> us;
+  us.reserve(frames);
+  uint64_t allocs0 = 0, passes0 = 0;
+
+  for (int f = 0; f < WARMUP + frames; f++) {
+    hostAdvanceMicros(FRAME_US);
+    if (c.run != loop) frameClock.tick(micros());   // loop() ticks it itself
+    c.prep((uint32_t)f);
+    if (f == WARMUP) { allocs0 = g_allocs; passes0 = overlay.passes() + g_legacyPasses; }
+
+    auto t0 = std::chrono::steady_clock::now();
+    c.run();
+    auto t1 = std::chrono::steady_clock::now();
+    if (f >= WARMUP) us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+  }
+  uint64_t allocs = g_allocs - allocs0;
+  uint64_t passes = overlay.passes() + g_legacyPasses - passes0;
+
+  std::vector<double> s = us;
+  std::sort(s.begin(), s.end());
+  double sum = 0;
+  for (double v : s) sum += v;
+  Stats st;
+  st.mean = sum / s.size();
+  st.p50  = s[s.size() / 2];
+  st.p99  = s[std::min(s.size() - 1, (s.size() * 99) / 100)];
+  st.max  = s.back();
+  st.allocsPerFrame = (double)allocs / frames;
+  st.passesPerFrame = (double)passes / frames;
+  return st;
+}
+
+int main(int argc, char** argv) {
+  int frames = 2000, threads = 1;
+  bool csv = false;
+  const char* only = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = max(1, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--csv")) csv = true;
+    else if (!strcmp(argv[i], "--only") && i + 1 < argc) only = argv[++i];
+    else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]) > 1 ? 2 : 1;
+    else { fprintf(stderr, "usage: %s [--frames N] [--csv] [--only NAME] [--threads 2]\n", argv[0]); return 2; }
+  }
+
+  hostSetMicros(START_US);
+  g_chip.attach(STROBE_PIN, RESET_PIN, ANALOG_PIN);
+  setup();
+  if (threads > 1) {
+    stripFork.begin();
+    if (!csv) printf("strip 2 on a worker thread, %u hardware threads\n", std::thread::hardware_concurrency());
+  }
+
+  const char* extra = threads > 1 ? ",mean_2t_us,speedup" : "";
+  if (csv) printf("effect,mean_us,p50_us,p99_us,max_us,allocs_per_frame,passes_per_frame%s\n", extra);
+  else     printf("%-22s %9s %9s %9s %9s %8s %7s%s\n", "effect", "mean_us", "p50_us", "p99_us", "max_us", "allocs",
+                  "passes", threads > 1 ? "   mean_2t  speedup" : "");
+
+  for (const BenchCase& c : CASES) {
+    if (only && !strstr(c.name, only)) continue;
+    stripFork.setEnabled(false);
+    Stats st = runCase(c, frames);
+    if (csv) printf("%s,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f", c.name, st.mean, st.p50, st.p99, st.max, st.allocsPerFrame,
+                    st.passesPerFrame);
+    else     printf("%-22s %9.2f %9.2f %9.2f %9.2f %8.2f %7.2f", c.name, st.mean, st.p50, st.p99, st.max,
+                    st.allocsPerFrame, st.passesPerFrame);
+    if (threads > 1) {
+      stripFork.setEnabled(true);
+      Stats mt = runCase(c, frames);
+      if (csv) printf(",%.2f,%.2f", mt.mean, st.mean / mt.mean);
+      else     printf(" %9.2f %7.2fx", mt.mean, st.mean / mt.mean);
+    }
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,3 @@
+#pragma once
+// ============== Host shim: Adafruit GFX ==============
+#include "Arduino.h"
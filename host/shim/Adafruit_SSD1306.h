@@ -0,0 +1,64 @@
+#pragma once
+// ============== Host shim: SSD1306 OLED ==============
+// Accepts the calls main.cpp makes and counts full-buffer pushes. Commands
+// and display() go through the Wire shim with the real library's framing,
+// so the harness can see how often and how much the UI hits the I2C bus.
+// Nothing is drawn: the buffer stays blank.
+
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+class Adafruit_SSD1306 {
+public:
+  uint32_t pushes = 0;   // display() calls (1 KB each on the real bus)
+
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* wire, int8_t) : w_(w), h_(h), wire_(wire) {}
+  bool begin(uint8_t, uint8_t) { return true; }
+  void clearDisplay() {}
+  void display() {
+    ++pushes;
+    static const uint8_t cmds[] = { SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, 127 };
+    for (uint8_t c : cmds) ssd1306_command(c);
+    for (uint16_t i = 0; i < sizeof(buffer_); i += 127) {   // WIRE_MAX on ESP32: 128 - control byte
+      wire_->beginTransmission(0x3C);
+      wire_->write((uint8_t)0x40);
+      wire_->write(buffer_ + i, min<uint16_t>(127, sizeof(buffer_) - i));
+      wire_->endTransmission();
+    }
+  }
+  void ssd1306_command(uint8_t c) {
+    wire_->beginTransmission(0x3C);
+    wire_->write((uint8_t)0x00);
+    wire_->write(c);
+    wire_->endTransmission();
+  }
+  uint8_t* getBuffer() { return buffer_; }
+  void setTextWrap(bool) {}
+  void setTextSize(uint8_t) {}
+  void setTextColor(uint16_t) {}
+  void setCursor(int16_t, int16_t) {}
+  void fillRect(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+  int16_t width() const  { return w_; }
+  int16_t height() const { return h_; }
+
+  size_t print(const char*) { return 0; }
+  size_t print(char) { return 0; }
+  size_t print(int) { return 0; }
+  size_t print(unsigned) { return 0; }
+  size_t print(long) { return 0; }
+  size_t print(unsigned long) { return 0; }
+  size_t print(double, int = 2) { return 0; }
+  size_t println() { return 0; }
+  template <typename T> size_t println(T v) { return print(v); }
+
+private:
+  uint8_t  w_, h_;
+  TwoWire* wire_;
+  uint8_t  buffer_[128 * 64 / 8] = {};
+};
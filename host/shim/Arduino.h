@@ -0,0 +1,127 @@
+#pragma once
+// ============== Host shim: Arduino core ==============
+// Just enough of the ESP32 Arduino API for src/main.cpp to compile and run
+// on a Linux box. Time is virtual: millis()/micros() only move when the host
+// harness (or delayMicroseconds) advances them, so runs are scripted.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// ---- virtual clock ----
+inline uint64_t g_hostMicros = 0;
+inline uint32_t g_hostUsPerClockRead = 0;   // optional: time that passes after each read
+inline uint64_t g_hostClockReads = 0;
+
+inline void     hostSetMicros(uint64_t us)     { g_hostMicros = us; }
+inline void     hostAdvanceMicros(uint64_t us) { g_hostMicros += us; }
+inline uint64_t hostClockRead() {
+  g_hostClockReads++;
+  const uint64_t t = g_hostMicros;
+  g_hostMicros += g_hostUsPerClockRead;
+  return t;
+}
+inline uint32_t micros() { return (uint32_t)hostClockRead(); }
+inline uint32_t millis() { return (uint32_t)(hostClockRead() / 1000ULL); }
+inline void delayMicroseconds(uint32_t us) { g_hostMicros += us; }
+inline void delay(uint32_t ms) { g_hostMicros += (uint64_t)ms * 1000ULL; }
+
+// ---- GPIO / ADC (pins are plain arrays the harness can poke) ----
+struct HostPins {
+  uint8_t level[64];
+  HostPins() { memset(level, HIGH, sizeof(level)); }  // idle HIGH (pull-ups / active-low buttons)
+};
+inline HostPins g_hostPins;
+inline uint16_t g_hostAnalog[64];
+inline uint16_t g_hostTouch[64];
+inline int  (*g_hostAnalogHook)(uint8_t pin) = nullptr;           // optional fake ADC
+inline void (*g_hostDigitalWriteHook)(uint8_t pin, uint8_t v) = nullptr;  // optional fake chip
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t v) {
+  g_hostPins.level[pin & 63] = v ? HIGH : LOW;
+  if (g_hostDigitalWriteHook) g_hostDigitalWriteHook(pin, v ? HIGH : LOW);
+}
+inline int  digitalRead(uint8_t pin) { return g_hostPins.level[pin & 63]; }
+inline uint16_t analogRead(uint8_t pin) {
+  if (g_hostAnalogHook) return (uint16_t)g_hostAnalogHook(pin);
+  return g_hostAnalog[pin & 63];
+}
+inline uint16_t touchRead(uint8_t pin) {
+  return g_hostTouch[pin & 63] ? g_hostTouch[pin & 63] : 100;  // untouched
+}
+
+enum adc_attenuation_t { ADC_0db, ADC_2_5db, ADC_6db, ADC_11db };
+inline void analogReadResolution(uint8_t) {}
+inline void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+
+// ---- math helpers ----
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  const long dividend = out_max - out_min;
+  const long divisor  = in_max - in_min;
+  if (divisor == 0) return -1;
+  return (x - in_min) * dividend / divisor + out_min;
+}
+
+inline uint32_t g_hostRandState = 0x2545F491u;
+inline void randomSeed(unsigned long seed) { g_hostRandState = seed ? (uint32_t)seed : 1u; }
+inline long random(long howbig) {
+  if (howbig <= 0) return 0;
+  uint32_t x = g_hostRandState;
+  x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+  g_hostRandState = x;
+  return (long)(x % (uint32_t)howbig);
+}
+inline long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+// ---- Serial (goes to stderr so harness stdout stays machine-readable) ----
+struct HostSerial {
+  const char* rx = nullptr;   // scripted input, consumed by read()
+
+  void begin(unsigned long) {}
+  int  available() { return (rx && *rx) ? (int)strlen(rx) : 0; }
+  int  read() { return (rx && *rx) ? (uint8_t)*rx++ : -1; }
+  size_t write(uint8_t c) { return fputc(c, stderr) == EOF ? 0 : 1; }
+  size_t write(const uint8_t* b, size_t n) { return fwrite(b, 1, n, stderr); }
+  int  availableForWrite() { return 128; }
+
+  size_t print(const char* s)        { return (size_t)fprintf(stderr, "%s", s); }
+  size_t print(char c)               { return (size_t)fprintf(stderr, "%c", c); }
+  size_t print(int v)                { return (size_t)fprintf(stderr, "%d", v); }
+  size_t print(unsigned v)           { return (size_t)fprintf(stderr, "%u", v); }
+  size_t print(long v)               { return (size_t)fprintf(stderr, "%ld", v); }
+  size_t print(unsigned long v)      { return (size_t)fprintf(stderr, "%lu", v); }
+  size_t print(double v, int d = 2)  { return (size_t)fprintf(stderr, "%.*f", d, v); }
+  size_t println()                   { return print("\n"); }
+  template <typename T> size_t println(T v)           { size_t n = print(v); return n + println(); }
+  template <typename T> size_t println(T v, int d)    { size_t n = print(v, d); return n + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    va_list ap; va_start(ap, fmt);
+    int n = vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    return n < 0 ? 0 : (size_t)n;
+  }
+};
+inline HostSerial Serial;
@@ -0,0 +1,278 @@
+#pragma once
+// ============== Host shim: FastLED subset ==============
+// CRGB / CHSV / CRGBPalette16 and the 8-bit math main.cpp uses. The scale,
+// blend, sin8 and palette code follow FastLED 3.9's C fallbacks so rendered
+// pixels match the device; inoise8 and hsv2rgb are cheaper stand-ins.
+
+#include "Arduino.h"
+
+typedef uint8_t fract8;
+enum TBlendType { NOBLEND = 0, LINEARBLEND = 1 };
+enum EOrder { RGB = 0012, RBG = 0021, GRB = 0102, GBR = 0120, BRG = 0201, BGR = 0210 };
+struct WS2812B {};
+
+// ---- 8-bit math ----
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+  return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8);
+}
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+  return (uint8_t)((((uint16_t)i * (uint16_t)scale) >> 8) + ((i && scale) ? 1 : 0));
+}
+inline uint8_t qadd8(uint8_t i, uint8_t j) { unsigned t = i + j; return t > 255 ? 255 : (uint8_t)t; }
+inline uint8_t qsub8(uint8_t i, uint8_t j) { int t = i - j; return t < 0 ? 0 : (uint8_t)t; }
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+  uint16_t partial = (uint16_t)((a << 8) | b);
+  partial += (uint16_t)(b * amountOfB);
+  partial -= (uint16_t)(a * amountOfB);
+  return (uint8_t)(partial >> 8);
+}
+
+inline uint8_t sin8(uint8_t theta) {
+  static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+  uint8_t offset = theta;
+  if (theta & 0x40) offset = (uint8_t)255 - offset;
+  offset &= 0x3F;
+  uint8_t secoffset = offset & 0x0F;
+  if (theta & 0x40) ++secoffset;
+  uint8_t section = offset >> 4;
+  const uint8_t* p = b_m16_interleave + section * 2;
+  uint8_t b = p[0], m16 = p[1];
+  uint8_t mx = (uint8_t)((m16 * secoffset) >> 4);
+  int8_t y = (int8_t)(mx + b);
+  if (theta & 0x80) y = (int8_t)-y;
+  return (uint8_t)(y + 128);
+}
+inline uint8_t cos8(uint8_t theta) { return sin8((uint8_t)(theta + 64)); }
+
+// ---- FastLED's 16-bit LCG ----
+inline uint16_t g_rand16seed = 1337;
+inline void     random16_set_seed(uint16_t seed) { g_rand16seed = seed; }
+inline uint16_t random16() { g_rand16seed = (uint16_t)(g_rand16seed * 2053u + 13849u); return g_rand16seed; }
+inline uint16_t random16(uint16_t lim) { return (uint16_t)(((uint32_t)random16() * lim) >> 16); }
+inline uint8_t  random8() { uint16_t s = random16(); return (uint8_t)((s & 0xFF) + (s >> 8)); }
+inline uint8_t  random8(uint8_t lim) { return (uint8_t)((random8() * lim) >> 8); }
+inline uint8_t  random8(uint8_t lo, uint8_t lim) { return (uint8_t)(random8((uint8_t)(lim - lo)) + lo); }
+
+// Hash-lattice value noise: same range and smoothness class as FastLED's
+// Perlin inoise8, not bit-identical.
+inline uint8_t inoise8(uint16_t x, uint16_t y) {
+  auto h = [](uint16_t ix, uint16_t iy) -> uint8_t {
+    uint32_t v = (uint32_t)ix * 0x27d4eb2dU ^ (uint32_t)iy * 0x165667b1U;
+    v ^= v >> 15; v *= 0x85ebca6bU; v ^= v >> 13;
+    return (uint8_t)v;
+  };
+  uint16_t ix = x >> 8, iy = y >> 8;
+  uint8_t fx = x & 0xFF, fy = y & 0xFF;
+  uint8_t a = blend8(h(ix, iy),     h(ix + 1, iy),     fx);
+  uint8_t b = blend8(h(ix, iy + 1), h(ix + 1, iy + 1), fx);
+  return blend8(a, b, fy);
+}
+
+// ---- colors ----
+struct CHSV {
+  uint8_t h, s, v;
+  CHSV() : h(0), s(0), v(0) {}
+  CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+struct CRGB {
+  union {
+    struct { uint8_t r, g, b; };
+    uint8_t raw[3];
+  };
+
+  enum HTMLColorCode : uint32_t {
+    Aqua = 0x00FFFF, Aquamarine = 0x7FFFD4, Black = 0x000000, Blue = 0x0000FF,
+    BlueViolet = 0x8A2BE2, CadetBlue = 0x5F9EA0, Chartreuse = 0x7FFF00,
+    CornflowerBlue = 0x6495ED, Crimson = 0xDC143C, Cyan = 0x00FFFF,
+    DarkBlue = 0x00008B, DarkCyan = 0x008B8B, DarkGreen = 0x006400,
+    DarkOliveGreen = 0x556B2F, DarkOrange = 0xFF8C00, DarkRed = 0x8B0000,
+    DarkTurquoise = 0x00CED1, DeepPink = 0xFF1493, DeepSkyBlue = 0x00BFFF,
+    ForestGreen = 0x228B22, Gold = 0xFFD700, Green = 0x008000, Indigo = 0x4B0082,
+    LawnGreen = 0x7CFC00, LightGreen = 0x90EE90, LightSkyBlue = 0x87CEFA,
+    LimeGreen = 0x32CD32, Magenta = 0xFF00FF, Maroon = 0x800000,
+    MediumAquamarine = 0x66CDAA, MediumBlue = 0x0000CD, MediumVioletRed = 0xC71585,
+    MidnightBlue = 0x191970, Navy = 0x000080, OliveDrab = 0x6B8E23,
+    Orange = 0xFFA500, OrangeRed = 0xFF4500, Purple = 0x800080, Red = 0xFF0000,
+    SeaGreen = 0x2E8B57, Teal = 0x008080, Violet = 0xEE82EE, White = 0xFFFFFF,
+    Yellow = 0xFFFF00, YellowGreen = 0x9ACD32
+  };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t colorcode)
+    : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+  CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+  CRGB(const CHSV& hsv) { setHSV(hsv); }
+
+  uint8_t&       operator[](uint8_t x)       { return raw[x]; }
+  const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+  CRGB& operator+=(const CRGB& rhs) {
+    r = qadd8(r, rhs.r); g = qadd8(g, rhs.g); b = qadd8(b, rhs.b);
+    return *this;
+  }
+  CRGB& nscale8(uint8_t s)       { r = scale8(r, s); g = scale8(g, s); b = scale8(b, s); return *this; }
+  CRGB& nscale8_video(uint8_t s) { r = scale8_video(r, s); g = scale8_video(g, s); b = scale8_video(b, s); return *this; }
+  CRGB& fadeLightBy(uint8_t f)   { return nscale8(255 - f); }
+  CRGB& fadeToBlackBy(uint8_t f) { return nscale8(255 - f); }
+
+  // Simple spectrum conversion (FastLED's hsv2rgb_rainbow is warmer; close enough for timing)
+  void setHSV(const CHSV& c) {
+    uint8_t region = c.h / 43;
+    uint8_t rem    = (uint8_t)((c.h - region * 43) * 6);
+    uint8_t p = scale8(c.v, 255 - c.s);
+    uint8_t q = scale8(c.v, 255 - scale8(c.s, rem));
+    uint8_t t = scale8(c.v, 255 - scale8(c.s, 255 - rem));
+    switch (region) {
+      case 0:  r = c.v; g = t;   b = p;   break;
+      case 1:  r = q;   g = c.v; b = p;   break;
+      case 2:  r = p;   g = c.v; b = t;   break;
+      case 3:  r = p;   g = q;   b = c.v; break;
+      case 4:  r = t;   g = p;   b = c.v; break;
+      default: r = c.v; g = p;   b = q;   break;
+    }
+  }
+};
+
+inline bool operator==(const CRGB& a, const CRGB& b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+inline bool operator!=(const CRGB& a, const CRGB& b) { return !(a == b); }
+
+inline CRGB& nblend(CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay) {
+  if (amountOfOverlay == 0) return existing;
+  if (amountOfOverlay == 255) { existing = overlay; return existing; }
+  existing.r = blend8(existing.r, overlay.r, amountOfOverlay);
+  existing.g = blend8(existing.g, overlay.g, amountOfOverlay);
+  existing.b = blend8(existing.b, overlay.b, amountOfOverlay);
+  return existing;
+}
+
+// ---- palettes ----
+struct CRGBPalette16 {
+  CRGB entries[16];
+
+  CRGBPalette16() {}
+  CRGBPalette16(const CRGB& c00, const CRGB& c01, const CRGB& c02, const CRGB& c03,
+                const CRGB& c04, const CRGB& c05, const CRGB& c06, const CRGB& c07,
+                const CRGB& c08, const CRGB& c09, const CRGB& c10, const CRGB& c11,
+                const CRGB& c12, const CRGB& c13, const CRGB& c14, const CRGB& c15) {
+    const CRGB* src[16] = { &c00, &c01, &c02, &c03, &c04, &c05, &c06, &c07,
+                            &c08, &c09, &c10, &c11, &c12, &c13, &c14, &c15 };
+    for (int i = 0; i < 16; i++) entries[i] = *src[i];
+  }
+  explicit CRGBPalette16(const uint32_t (&codes)[16]) {
+    for (int i = 0; i < 16; i++) entries[i] = CRGB(codes[i]);
+  }
+
+  CRGB&       operator[](uint8_t x)       { return entries[x]; }
+  const CRGB& operator[](uint8_t x) const { return entries[x]; }
+
+  bool operator==(const CRGBPalette16& o) const { return memcmp(entries, o.entries, sizeof(entries)) == 0; }
+  bool operator!=(const CRGBPalette16& o) const { return !(*this == o); }
+};
+
+inline CRGB ColorFromPalette(const CRGBPalette16& pal, uint8_t index,
+                             uint8_t brightness = 255, TBlendType blendType = LINEARBLEND) {
+  uint8_t hi4 = index >> 4;
+  uint8_t lo4 = index & 0x0F;
+  const CRGB& entry = pal[hi4];
+  uint8_t red1 = entry.r, green1 = entry.g, blue1 = entry.b;
+
+  if (lo4 && blendType != NOBLEND) {
+    const CRGB& next = (hi4 == 15) ? pal[0] : pal[hi4 + 1];
+    uint8_t f2 = (uint8_t)(lo4 << 4);
+    uint8_t f1 = 255 - f2;
+    red1   = (uint8_t)(scale8(red1, f1)   + scale8(next.r, f2));
+    green1 = (uint8_t)(scale8(green1, f1) + scale8(next.g, f2));
+    blue1  = (uint8_t)(scale8(blue1, f1)  + scale8(next.b, f2));
+  }
+
+  if (brightness != 255) {
+    if (brightness) {
+      ++brightness;
+      if (red1)   red1   = scale8(red1, brightness);
+      if (green1) green1 = scale8(green1, brightness);
+      if (blue1)  blue1  = scale8(blue1, brightness);
+    } else {
+      red1 = green1 = blue1 = 0;
+    }
+  }
+  return CRGB(red1, green1, blue1);
+}
+
+inline void nblendPaletteTowardPalette(CRGBPalette16& current, const CRGBPalette16& target,
+                                       uint8_t maxChanges) {
+  uint8_t* p1 = (uint8_t*)current.entries;
+  const uint8_t* p2 = (const uint8_t*)target.entries;
+  const uint8_t totalChannels = sizeof(CRGBPalette16);
+  uint8_t changes = 0;
+  for (uint8_t i = 0; i < totalChannels; i++) {
+    if (p1[i] == p2[i]) continue;
+    if (p1[i] < p2[i]) { ++p1[i]; ++changes; }
+    if (p1[i] > p2[i]) { --p1[i]; ++changes; if (p1[i] > p2[i]) --p1[i]; }
+    if (changes >= maxChanges) break;
+  }
+}
+
+inline const uint32_t kRainbowColors[16] = {
+  0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+  0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B };
+inline const uint32_t kPartyColors[16] = {
+  0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+  0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9 };
+inline const uint32_t kOceanColors[16] = {
+  CRGB::MidnightBlue, CRGB::DarkBlue, CRGB::MidnightBlue, CRGB::Navy,
+  CRGB::DarkBlue, CRGB::MediumBlue, CRGB::SeaGreen, CRGB::Teal,
+  CRGB::CadetBlue, CRGB::Blue, CRGB::DarkCyan, CRGB::CornflowerBlue,
+  CRGB::Aquamarine, CRGB::SeaGreen, CRGB::Aqua, CRGB::LightSkyBlue };
+inline const uint32_t kForestColors[16] = {
+  CRGB::DarkGreen, CRGB::DarkGreen, CRGB::DarkOliveGreen, CRGB::DarkGreen,
+  CRGB::Green, CRGB::ForestGreen, CRGB::OliveDrab, CRGB::Green,
+  CRGB::SeaGreen, CRGB::MediumAquamarine, CRGB::LimeGreen, CRGB::YellowGreen,
+  CRGB::LightGreen, CRGB::LawnGreen, CRGB::MediumAquamarine, CRGB::ForestGreen };
+inline const uint32_t kHeatColors[16] = {
+  0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+  0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF };
+
+inline const CRGBPalette16 RainbowColors_p(kRainbowColors);
+inline const CRGBPalette16 PartyColors_p(kPartyColors);
+inline const CRGBPalette16 OceanColors_p(kOceanColors);
+inline const CRGBPalette16 ForestColors_p(kForestColors);
+inline const CRGBPalette16 HeatColors_p(kHeatColors);
+
+// ---- buffer helpers ----
+inline void fill_solid(CRGB* leds, int n, const CRGB& c) { for (int i = 0; i < n; i++) leds[i] = c; }
+inline void fadeToBlackBy(CRGB* leds, uint16_t n, uint8_t fade) { for (uint16_t i = 0; i < n; i++) leds[i].nscale8(255 - fade); }
+inline void nscale8_video(CRGB* leds, uint16_t n, uint8_t s) { for (uint16_t i = 0; i < n; i++) leds[i].nscale8_video(s); }
+inline void fill_rainbow(CRGB* leds, int n, uint8_t initialhue, uint8_t deltahue = 5) {
+  CHSV hsv(initialhue, 240, 255);
+  for (int i = 0; i < n; i++) { leds[i] = hsv; hsv.h += deltahue; }
+}
+
+#define FL_CONCAT_(a, b) a##b
+#define FL_CONCAT(a, b)  FL_CONCAT_(a, b)
+#define EVERY_N_MILLISECONDS(N)                                                    \
+  static uint32_t FL_CONCAT(_everyLast, __LINE__) = 0;                             \
+  if ((uint32_t)(millis() - FL_CONCAT(_everyLast, __LINE__)) >= (uint32_t)(N) &&   \
+      ((FL_CONCAT(_everyLast, __LINE__) = millis()), true))
+
+// ---- controller ----
+struct HostFastLED {
+  struct Strip {
+    CRGB* leds; int n;
+    Strip& setLeds(CRGB* data, int nLeds) { leds = data; n = nLeds; return *this; }
+  };
+  Strip   strips[4] = {};
+  uint8_t count = 0;
+  uint8_t brightness = 255;
+  uint32_t shows = 0;
+  void (*onShow)() = nullptr;   // harness hook (frame capture)
+
+  template <typename CHIPSET, uint8_t DATA_PIN, EOrder ORDER>
+  void addLeds(CRGB* leds, int n) { if (count < 4) strips[count++] = { leds, n }; }
+  Strip&  operator[](int x) { return strips[x]; }
+  void    setBrightness(uint8_t b) { brightness = b; }
+  uint8_t getBrightness() const { return brightness; }
+  void    show() { ++shows; if (onShow) onShow(); }
+};
+inline HostFastLED FastLED;
@@ -0,0 +1,65 @@
+#pragma once
+// ============== Host shim: Preferences (NVS) ==============
+// Stands in for the NVS partition: namespaced key -> bytes that outlive any
+// one Preferences handle (as flash outlives a reboot). Counts committed
+// writes, and a harness can fail writes or plant / corrupt stored bytes.
+#include "Arduino.h"
+#include <map>
+#include <string>
+#include <vector>
+
+struct HostNvs {
+  std::map<std::string, std::map<std::string, std::vector<uint8_t>>> ns;
+  uint32_t writes = 0;          // committed puts
+  uint32_t bytesWritten = 0;
+  uint32_t failedWrites = 0;
+  bool     failWrites = false;  // every put fails while set
+
+  std::vector<uint8_t>* find(const std::string& n, const std::string& key) {
+    auto a = ns.find(n);
+    if (a == ns.end()) return nullptr;
+    auto b = a->second.find(key);
+    return b == a->second.end() ? nullptr : &b->second;
+  }
+};
+inline HostNvs g_hostNvs;
+
+class Preferences {
+public:
+  // Like NVS, a namespace can't be opened read-only before it exists.
+  bool begin(const char* name, bool readOnly = false) {
+    if (readOnly && !g_hostNvs.ns.count(name)) return false;
+    ns_ = name; ro_ = readOnly; open_ = true;
+    return true;
+  }
+  void end() { open_ = false; }
+
+  size_t getBytesLength(const char* key) {
+    const std::vector<uint8_t>* v = open_ ? g_hostNvs.find(ns_, key) : nullptr;
+    return v ? v->size() : 0;
+  }
+  // 0 if buf is smaller than the stored value, as on the device
+  size_t getBytes(const char* key, void* buf, size_t len) {
+    const std::vector<uint8_t>* v = open_ ? g_hostNvs.find(ns_, key) : nullptr;
+    if (!v || len < v->size()) return 0;
+    memcpy(buf, v->data(), v->size());
+    return v->size();
+  }
+  size_t putBytes(const char* key, const void* value, size_t len) {
+    if (!open_ || ro_) return 0;
+    if (g_hostNvs.failWrites) { g_hostNvs.failedWrites++; return 0; }
+    const uint8_t* p = (const uint8_t*)value;
+    g_hostNvs.ns[ns_][key].assign(p, p + len);
+    g_hostNvs.writes++;
+    g_hostNvs.bytesWritten += (uint32_t)len;
+    return len;
+  }
+  bool remove(const char* key) {
+    if (!open_ || ro_) return false;
+    return g_hostNvs.ns[ns_].erase(key) > 0;
+  }
+
+private:
+  std::string ns_;
+  bool ro_ = false, open_ = false;
+};
@@ -0,0 +1,18 @@
+#pragma once
+// ============== Host shim: Wire (I2C) ==============
+// Counts what would go on the bus, so host tools can see the UI's I2C cost.
+#include "Arduino.h"
+
+struct HostTwoWire {
+  uint32_t bytes = 0;           // address + payload bytes, every transfer
+  uint32_t transmissions = 0;
+
+  void begin(int = -1, int = -1) {}
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t) { ++transmissions; ++bytes; }
+  size_t write(uint8_t) { ++bytes; return 1; }
+  size_t write(const uint8_t*, size_t n) { bytes += (uint32_t)n; return n; }
+  uint8_t endTransmission(bool = true) { return 0; }
+};
+inline HostTwoWire Wire;
+typedef HostTwoWire TwoWire;
@@ -0,0 +1,72 @@
+#pragma once
+// ============== Host shim: fake MSGEQ7 ==============
+// Follows RESET/STROBE edges like the real chip and answers ADC reads with
+// the level of the selected band. Reads taken before the output has settled
+// return the previous band's level and are counted, so timing bugs show up
+// as wrong band data, just like on the rig.
+
+#include "Arduino.h"
+
+struct FakeMsgeq7 {
+  uint16_t level[7] = {};        // ADC counts each band "hears"
+  uint32_t settleUs = 36;        // strobe low -> output valid
+  uint32_t minStrobeUs = 72;     // strobe -> strobe, reset -> strobe
+
+  // counters
+  uint32_t reads = 0;
+  uint32_t settleViolations = 0;
+  uint32_t strobeViolations = 0;
+  uint32_t minSettleSeenUs = 0xFFFFFFFF;
+
+  void onStrobe(bool high, uint32_t nowUs) {
+    if (!high && strobeHigh_) {                        // falling edge selects next band
+      uint32_t since = nowUs - lastStrobeFallUs_;
+      if (band_ < 0) since = nowUs - resetFallUs_;
+      if (since < minStrobeUs) ++strobeViolations;
+      prevBand_ = band_;
+      band_ = (band_ + 1) % 7;
+      lastStrobeFallUs_ = nowUs;
+    }
+    strobeHigh_ = high;
+  }
+
+  void onReset(bool high, uint32_t nowUs) {
+    if (high) { band_ = -1; prevBand_ = -1; }
+    else if (resetHigh_) resetFallUs_ = nowUs;
+    resetHigh_ = high;
+  }
+
+  uint16_t read(uint32_t nowUs) {
+    ++reads;
+    if (band_ < 0) return 0;
+    uint32_t settled = nowUs - lastStrobeFallUs_;
+    if (settled < minSettleSeenUs) minSettleSeenUs = settled;
+    if (settled < settleUs) {
+      ++settleViolations;
+      return prevBand_ < 0 ? 0 : level[prevBand_];
+    }
+    return level[band_];
+  }
+
+  // Route the Arduino shim's pins/ADC through this chip.
+  static FakeMsgeq7*& active() { static FakeMsgeq7* p = nullptr; return p; }
+  void attach(uint8_t strobePin, uint8_t resetPin, uint8_t analogPin) {
+    active() = this;
+    strobePin_ = strobePin; resetPin_ = resetPin; analogPin_ = analogPin;
+    g_hostDigitalWriteHook = [](uint8_t pin, uint8_t v) {
+      FakeMsgeq7* c = active();
+      if (pin == c->strobePin_) c->onStrobe(v == HIGH, micros());
+      if (pin == c->resetPin_)  c->onReset(v == HIGH, micros());
+    };
+    g_hostAnalogHook = [](uint8_t pin) -> int {
+      FakeMsgeq7* c = active();
+      return (pin == c->analogPin_) ? c->read(micros()) : g_hostAnalog[pin & 63];
+    };
+  }
+
+private:
+  bool     strobeHigh_ = true, resetHigh_ = false;
+  int8_t   band_ = -1, prevBand_ = -1;
+  uint32_t lastStrobeFallUs_ = 0, resetFallUs_ = 0;
+  uint8_t  strobePin_ = 0xFF, resetPin_ = 0xFF, analogPin_ = 0xFF;
+};
@@ -0,0 +1,57 @@
+#pragma once
+// ============== Host shim: forked runs ==============
+// The sims run each case in a fork of the post-setup() process, so statics
+// inside main.cpp start fresh every time. forkRun() runs fn in the child,
+// hands back whatever it writes to its pipe, and returns its exit status
+// (fn's return value), or -1 if the fork failed or the child died.
+// fnv() is the FNV-1a hash the sims fingerprint frames with.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <unistd.h>
+#include <sys/wait.h>
+
+constexpr uint32_t FNV_SEED = 2166136261u;
+
+static inline uint32_t fnv(uint32_t h, const void* p, size_t n) {
+  const uint8_t* b = (const uint8_t*)p;
+  for (size_t i = 0; i < n; i++) h = (h ^ b[i]) * 16777619u;
+  return h;
+}
+
+// Child side: all of p to fd, or exit 2.
+static inline void forkWrite(int fd, const void* p, size_t n) {
+  const uint8_t* b = (const uint8_t*)p;
+  while (n) {
+    ssize_t w = write(fd, b, n);
+    if (w <= 0) _exit(2);
+    b += w;
+    n -= (size_t)w;
+  }
+}
+
+static inline int forkRun(const std::function<int(int fd)>& fn, std::string* out = nullptr) {
+  int fd[2];
+  if (pipe(fd)) { perror("pipe"); return -1; }
+  fflush(stdout);                                   // or the child repeats what's buffered
+  pid_t pid = fork();
+  if (pid < 0) { perror("fork"); close(fd[0]); close(fd[1]); return -1; }
+  if (pid == 0) {
+    close(fd[0]);
+    int rc = fn(fd[1]);
+    close(fd[1]);
+    fflush(stdout);
+    _exit(rc);
+  }
+  close(fd[1]);
+  if (out) out->clear();
+  char buf[4096];
+  ssize_t n;
+  while ((n = read(fd[0], buf, sizeof(buf))) > 0) if (out) out->append(buf, (size_t)n);
+  close(fd[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
@@ -0,0 +1,29 @@
+#pragma once
+// ============== Host shim: scripted band input ==============
+// Deterministic stand-in for the analyzer output: 120 BPM kick, 8th-note
+// hats, drifting mids, as a function of the virtual clock. Include after
+// src/main.cpp (writes bandNorm / audioPeakN and steps the scene level).
+
+static inline uint8_t decayHit(uint32_t ms, uint32_t period, uint32_t decayMs, uint8_t peak, uint8_t idle) {
+  uint32_t ph = ms % period;
+  if (ph >= decayMs) return idle;
+  return (uint8_t)(idle + (uint32_t)(peak - idle) * (decayMs - ph) / decayMs);
+}
+
+static inline void scriptLevels(uint32_t ms, uint8_t out[7]) {
+  uint8_t kick = decayHit(ms, 500, 150, 250, 30);    // 120 BPM
+  uint8_t hats = decayHit(ms, 250,  60, 220, 20);    // 8th notes
+  uint8_t mids = (uint8_t)(90 + 60 * sinf(ms * 0.0021f));
+  out[0] = kick;  out[1] = kick;
+  out[2] = mids;  out[3] = mids;  out[4] = (uint8_t)(mids * 3 / 4);
+  out[5] = hats;  out[6] = (uint8_t)(hats * 3 / 4);
+}
+
+static inline void scriptBands(uint32_t ms) {
+  scriptLevels(ms, bandNorm);
+
+  uint8_t peak = 0;
+  for (int i = 0; i < 7; i++) if (bandNorm[i] > peak) peak = bandNorm[i];
+  audioPeakN = peak;
+  updateSceneLevel(sens(audioPeakN));
+}
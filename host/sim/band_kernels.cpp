@@ -0,0 +1,192 @@
+// ============== Band analyzer: float reference vs Q15 kernel ==============
+// Replays band traces through BandAnalyzerFloat and BandAnalyzerQ15 side by
+// side and compares norm[] per band per frame, plus floor/crest tracking.
+// Traces come from a serial log captured in 'u' trace mode (lines
+// "BR,b0,...,b6" of raw 12-bit ADC; anything else is skipped), or from a
+// built-in synthetic set (club loop, quiet room -> loud -> fade, sweeps,
+// clipping/dropouts). Also checks the companding LUT against sqrtf over
+// every Q16 ratio.
+//
+// Fails if any norm differs by more than --tol LSB or more than 1% of
+// band-frames differ by more than 1 LSB.
+//
+//   pio run -e native_bands && .pio/build/native_bands/program [LOG] [--tol N]
+
+#include <Arduino.h>
+#include "band_analyzer.h"
+
+#include <vector>
+#include <chrono>
+
+struct RawFrame { uint16_t b[BAND_COUNT]; };
+
+static bool loadTrace(const char* path, std::vector<RawFrame>& out) {
+  FILE* f = fopen(path, "r");
+  if (!f) { fprintf(stderr, "can't open %s\n", path); return false; }
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    const char* p = strstr(line, "BR,");
+    if (!p) continue;
+    p += 3;
+    RawFrame rf = {};
+    int got = 0;
+    for (; got < BAND_COUNT; got++) {
+      char* endp;
+      unsigned long v = strtoul(p, &endp, 10);
+      if (endp == p) break;
+      rf.b[got] = (uint16_t)min(v, 4095UL);
+      p = (*endp == ',') ? endp + 1 : endp;
+    }
+    if (got == BAND_COUNT) out.push_back(rf);
+  }
+  fclose(f);
+  return true;
+}
+
+static uint16_t clampAdc(float v) { return (uint16_t)constrain((int)(v + 0.5f), 0, 4095); }
+
+// 60 FPS frames, like loop() consumes them.
+static void synthClub(std::vector<RawFrame>& out, int seconds) {
+  for (int i = 0; i < seconds * 60; i++) {
+    float beat = fmodf(i * 128.0f / 3600.0f, 1.0f);          // 128 BPM
+    float kick = expf(-beat * 9.0f);
+    float hat  = expf(-fmodf(beat + 0.5f, 1.0f) * 20.0f);
+    RawFrame rf;
+    for (int b = 0; b < BAND_COUNT; b++) {
+      float base = 350 + 60 * b + random(0, 120);
+      float hit  = b < 2 ? 3300 * kick : (b >= 5 ? 2600 * hat : 900 * (kick + hat) * 0.5f);
+      rf.b[b] = clampAdc(base + hit);
+    }
+    out.push_back(rf);
+  }
+}
+
+static void synthRoom(std::vector<RawFrame>& out, int seconds) {
+  int n = seconds * 60;
+  for (int i = 0; i < n; i++) {
+    float env = i < n / 4 ? 0.0f : (i < 3 * n / 4 ? 1.0f : 1.0f - (float)(i - 3 * n / 4) / (n / 4));
+    RawFrame rf;
+    for (int b = 0; b < BAND_COUNT; b++) {
+      float hum = b == 0 ? 500 : 180;                          // mains hum in the lowest band
+      float mus = env * (1200 + 1400 * sinf(i * (0.05f + 0.03f * b) + b));
+      rf.b[b] = clampAdc(hum + random(0, 60) + max(0.0f, mus));
+    }
+    out.push_back(rf);
+  }
+}
+
+static void synthSweep(std::vector<RawFrame>& out, int seconds) {
+  for (int i = 0; i < seconds * 60; i++) {
+    RawFrame rf;
+    for (int b = 0; b < BAND_COUNT; b++) {
+      float ph = i / 600.0f * 2.0f * (float)M_PI - b * 0.6f;
+      rf.b[b] = clampAdc(2048 + 2000 * sinf(ph) + random(-30, 30));
+    }
+    out.push_back(rf);
+  }
+}
+
+static void synthEdges(std::vector<RawFrame>& out, int seconds) {
+  for (int i = 0; i < seconds * 60; i++) {
+    RawFrame rf;
+    int seg = (i / 90) % 4;                                    // 1.5 s each: clip, dropout, toggle, noise
+    for (int b = 0; b < BAND_COUNT; b++) {
+      uint16_t v = 0;
+      if (seg == 0) v = 4095;
+      else if (seg == 1) v = 0;
+      else if (seg == 2) v = (i + b) % 2 ? 4095 : 0;
+      else v = (uint16_t)random(0, 4096);
+      rf.b[b] = v;
+    }
+    out.push_back(rf);
+  }
+}
+
+struct Cmp {
+  uint32_t cells = 0, over1 = 0, worst = 0, peakDiff = 0;
+  double   sumAbs = 0, floorErr = 0, crestErr = 0;
+};
+
+static Cmp compare(const std::vector<RawFrame>& trace) {
+  BandAnalyzerFloat ref;
+  BandAnalyzerQ15   q;
+  Cmp c;
+  for (const RawFrame& rf : trace) {
+    uint8_t nr[BAND_COUNT], nq[BAND_COUNT];
+    uint8_t pr = ref.update(rf.b, nr);
+    uint8_t pq = q.update(rf.b, nq);
+    c.peakDiff = max<uint32_t>(c.peakDiff, abs((int)pr - (int)pq));
+    for (uint8_t b = 0; b < BAND_COUNT; b++) {
+      uint32_t d = (uint32_t)abs((int)nr[b] - (int)nq[b]);
+      c.cells++;
+      c.sumAbs += d;
+      if (d > 1) c.over1++;
+      if (d > c.worst) c.worst = d;
+      c.floorErr = max(c.floorErr, (double)fabsf(ref.floor900(b) - q.floor900(b)));
+      c.crestErr = max(c.crestErr, (double)fabsf(ref.crest900(b) - q.crest900(b)));
+    }
+  }
+  return c;
+}
+
+template <class A>
+static double nsPerFrame(const std::vector<RawFrame>& trace) {
+  A a;
+  uint8_t norm[BAND_COUNT];
+  volatile uint32_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < 20; rep++)
+    for (const RawFrame& rf : trace) sink = sink + a.update(rf.b, norm);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (20.0 * trace.size());
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  uint32_t tol = 2;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--tol") && i + 1 < argc) tol = (uint32_t)max(0, atoi(argv[++i]));
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else { fprintf(stderr, "usage: %s [LOG] [--tol LSB]\n", argv[0]); return 2; }
+  }
+
+  // compand LUT vs the float curve, every ratio
+  CompandLut lut;
+  uint32_t lutMismatch = 0, lutWorst = 0;
+  for (uint32_t r = 0; r <= 65536; r++) {
+    int want = (int)(sqrtf(r / 65536.0f) * 255.0f + 0.5f);
+    uint32_t d = (uint32_t)abs(want - (int)lut.apply(r));
+    if (d) lutMismatch++;
+    lutWorst = max(lutWorst, d);
+  }
+  printf("compand LUT: %u/65537 ratios differ from sqrtf, worst %u LSB\n", (unsigned)lutMismatch, (unsigned)lutWorst);
+  bool ok = lutWorst <= 1;
+
+  struct Named { const char* name; std::vector<RawFrame> frames; };
+  std::vector<Named> traces;
+  if (path) {
+    traces.push_back({ path, {} });
+    if (!loadTrace(path, traces.back().frames)) return 2;
+    if (traces.back().frames.empty()) { fprintf(stderr, "no BR lines in trace\n"); return 2; }
+  } else {
+    randomSeed(5);
+    traces.push_back({ "club",  {} }); synthClub(traces.back().frames, 120);
+    traces.push_back({ "room",  {} }); synthRoom(traces.back().frames, 120);
+    traces.push_back({ "sweep", {} }); synthSweep(traces.back().frames, 60);
+    traces.push_back({ "edges", {} }); synthEdges(traces.back().frames, 60);
+  }
+
+  for (const Named& t : traces) {
+    Cmp c = compare(t.frames);
+    double over1Pct = 100.0 * c.over1 / c.cells;
+    printf("%-6s frames=%6u  norm: mean|d|=%.3f worst=%u >1LSB=%.2f%%  peak worst=%u  floor err=%.2f crest err=%.2f (0..900)\n",
+           t.name, (unsigned)t.frames.size(), c.sumAbs / c.cells, (unsigned)c.worst, over1Pct,
+           (unsigned)c.peakDiff, c.floorErr, c.crestErr);
+    if (c.worst > tol || over1Pct > 1.0) ok = false;
+  }
+
+  const std::vector<RawFrame>& bench = traces.front().frames;
+  printf("host cost: float %.1f ns/frame, q15 %.1f ns/frame\n",
+         nsPerFrame<BandAnalyzerFloat>(bench), nsPerFrame<BandAnalyzerQ15>(bench));
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+// ============== Frame-budget controller replay ==============
+// Feeds per-frame stage timings through FrameBudget and reports what the
+// controller decided. Timings come from a serial log captured with the 'u'
+// key in trace mode (lines "BT,input,ui,audio,effect,overlay,dim,show"; any
+// other lines are skipped), or from a built-in synthetic set.
+//
+// The trace was captured at full quality, so the replay models each quality
+// level as a cost factor on the effect + overlay stages (--cost, percent per
+// level). Fails if the controller flaps (opposite moves closer than
+// --min-gap frames) or leaves a heavy trace overrunning as often as before.
+//
+//   pio run -e native_budget && .pio/build/native_budget/program [LOG] [--fps N] [--cost 100,90,...]
+
+#include <Arduino.h>
+#include "frame_budget.h"
+
+#include <vector>
+#include <string>
+
+struct TraceFrame { uint32_t us[FS_COUNT]; };
+
+static bool loadTrace(const char* path, std::vector<TraceFrame>& out) {
+  FILE* f = fopen(path, "r");
+  if (!f) { fprintf(stderr, "can't open %s\n", path); return false; }
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    const char* p = strstr(line, "BT,");
+    if (!p) continue;
+    p += 3;
+    TraceFrame tf = {};
+    int got = 0;
+    for (; got < FS_COUNT; got++) {
+      char* endp;
+      unsigned long v = strtoul(p, &endp, 10);
+      if (endp == p) break;
+      tf.us[got] = (uint32_t)v;
+      p = (*endp == ',') ? endp + 1 : endp;
+    }
+    if (got == FS_COUNT) out.push_back(tf);
+  }
+  fclose(f);
+  return true;
+}
+
+// 60 s at 60 FPS: light intro, a long heavy section with spikes, light outro.
+static void syntheticTrace(std::vector<TraceFrame>& out) {
+  randomSeed(11);
+  for (int i = 0; i < 3600; i++) {
+    TraceFrame tf = {};
+    bool heavy = i >= 900 && i < 2700;
+    tf.us[FS_INPUT]   = 300 + random(0, 150);
+    tf.us[FS_UI]      = (i % 6 == 0) ? 2500 : 80;          // OLED push every few frames
+    tf.us[FS_AUDIO]   = 400 + random(0, 60);
+    tf.us[FS_EFFECT]  = (heavy ? 13500 : 7000) + random(0, 1500);
+    tf.us[FS_OVERLAY] = (heavy ? 1800 : 300) + random(0, 400);
+    tf.us[FS_DIM]     = 250;
+    tf.us[FS_SHOW]    = 900 + random(0, 200);
+    if (heavy && random(0, 40) == 0) tf.us[FS_EFFECT] += 6000;  // occasional spike
+    out.push_back(tf);
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  uint8_t fps = 60;
+  std::vector<uint32_t> cost = { 100, 92, 85, 72, 60 };
+  uint32_t minGap = 60;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--fps") && i + 1 < argc) fps = (uint8_t)constrain(atoi(argv[++i]), 1, 240);
+    else if (!strcmp(argv[i], "--min-gap") && i + 1 < argc) minGap = (uint32_t)max(0, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--cost") && i + 1 < argc) {
+      cost.clear();
+      for (char* tok = strtok(argv[++i], ","); tok; tok = strtok(nullptr, ",")) cost.push_back((uint32_t)atoi(tok));
+    }
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else { fprintf(stderr, "usage: %s [LOG] [--fps N] [--cost P0,P1,...] [--min-gap FRAMES]\n", argv[0]); return 2; }
+  }
+  if (cost.empty()) cost.push_back(100);
+
+  std::vector<TraceFrame> trace;
+  if (path) { if (!loadTrace(path, trace)) return 2; }
+  else syntheticTrace(trace);
+  if (trace.empty()) { fprintf(stderr, "no BT lines in trace\n"); return 2; }
+
+  FrameBudget fb(fps, (uint8_t)(cost.size() - 1));
+  std::vector<uint32_t> framesAt(cost.size(), 0);
+  uint32_t rawOver = 0, modelOver = 0, changes = 0, flaps = 0;
+  uint32_t lastChange = 0;
+  int8_t lastDir = 0;
+
+  printf("trace: %s, %u frames, budget %luus @ %u FPS\n", path ? path : "synthetic",
+         (unsigned)trace.size(), (unsigned long)fb.periodUs(), fps);
+
+  for (uint32_t f = 0; f < trace.size(); f++) {
+    TraceFrame tf = trace[f];
+    uint32_t raw = 0;
+    for (uint8_t s = 0; s < FS_COUNT; s++) if (s != FS_SHOW) raw += tf.us[s];
+    if (raw > fb.periodUs()) rawOver++;
+
+    // what this frame would have cost at the current level
+    uint32_t pct = cost[fb.level()];
+    tf.us[FS_EFFECT]  = tf.us[FS_EFFECT]  * pct / 100;
+    tf.us[FS_OVERLAY] = tf.us[FS_OVERLAY] * pct / 100;
+    framesAt[fb.level()]++;
+
+    fb.feed(tf.us);
+    int8_t moved = fb.end();
+    if (fb.workUs() > fb.periodUs()) modelOver++;
+
+    if (moved) {
+      changes++;
+      if (lastDir && moved != lastDir && f - lastChange < minGap) flaps++;
+      printf("  frame %6u  t=%7.2fs  -> q%u  (work~%luus)\n", (unsigned)f, f / (double)fps,
+             fb.level(), (unsigned long)fb.emaUs());
+      lastChange = f;
+      lastDir = moved;
+    }
+  }
+
+  printf("levels:");
+  for (size_t l = 0; l < framesAt.size(); l++) printf(" q%u=%u", (unsigned)l, (unsigned)framesAt[l]);
+  printf("\nchanges=%u flaps=%u overruns raw=%u (%.1f%%) controlled=%u (%.1f%%)\n",
+         (unsigned)changes, (unsigned)flaps,
+         (unsigned)rawOver, 100.0 * rawOver / trace.size(),
+         (unsigned)modelOver, 100.0 * modelOver / trace.size());
+
+  bool ok = flaps == 0;
+  if (rawOver * 20 > trace.size() && modelOver >= rawOver) ok = false;   // heavy trace not helped
+  return ok ? 0 : 1;
+}
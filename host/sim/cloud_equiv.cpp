@@ -0,0 +1,146 @@
+// ============== Cloud renderer equivalence check ==============
+// Renders the same cloud fields through the fixed-point CloudField::render()
+// and the original float version (kept below as the golden reference) and
+// reports the worst per-channel difference. Anything above 1 LSB fails,
+// except black vs. the dimmest lit step (mask brightness 0 vs 1). Also checks
+// PaletteLut::at() against ColorFromPalette() for every index and brightness.
+//
+//   pio run -e native_clouds && .pio/build/native_clouds/program [--frames N]
+
+#include "../../src/main.cpp"
+#include <chrono>
+
+// ---- golden reference: the float renderer as it shipped ----
+static inline float refWrapDistF(float a, float b, float n) {
+  float d = fabsf(a - b);
+  return (d <= n - d) ? d : (n - d);
+}
+
+static inline float refSoftStep(float x, float halfLen, float edge) {
+  float inner = fmaxf(0.0f, halfLen - edge);
+  if (x >= halfLen) return 0.0f;
+  if (x <= inner)   return 1.0f;
+  float t = (x - inner) / fmaxf(1e-6f, (halfLen - inner));
+  return 1.0f - (t*t*(3.0f - 2.0f*t));
+}
+
+static void refRenderPaletteClouds(CRGB* led, bool reverseIndex, const CRGBPalette16& pal,
+                                   uint8_t baseV, Cloud* C, uint16_t t1, uint16_t t2, uint16_t t3) {
+  uint32_t nowUs = micros();
+  static uint32_t lastUs = nowUs;
+  uint32_t dtUs = nowUs - lastUs;
+  if (dtUs > 300000) dtUs = 300000;
+  float dt = dtUs / 1000000.0f;
+
+  for (uint8_t i = 0; i < CLOUD_COUNT; i++) {
+    C[i].center += C[i].speed * dt;
+    while (C[i].center < 0)         C[i].center += NUM_LEDS;
+    while (C[i].center >= NUM_LEDS) C[i].center -= NUM_LEDS;
+    float breath = 1.0f + CLOUD_BREATHE * sinf((millis() * 0.0015f) + (C[i].wobble * 0.0003f));
+    C[i].length = fminf(CLOUD_MAX_LEN, fmaxf(CLOUD_MIN_LEN, C[i].length * breath));
+  }
+  lastUs = nowUs;
+
+  fill_solid(led, NUM_LEDS, CRGB::Black);
+  for (int i = 0; i < NUM_LEDS; i++) {
+    uint8_t idx1 = sin8(i * 2 + (t1 >> 2));
+    uint8_t idx2 = sin8(i * 3 + (t2 >> 3));
+    uint8_t idx3 = sin8(i * 1 + (t3 >> 4));
+    uint8_t colorIndex = (idx1/3) + (idx2/3) + (idx3/3);
+    float m = 0.0f;
+    for (uint8_t k = 0; k < CLOUD_COUNT; k++) {
+      float d = refWrapDistF((float)i, C[k].center, (float)NUM_LEDS);
+      float w = refSoftStep(d, C[k].length * 0.5f, frameSettings().cloudEdge);
+      if (w > m) m = w;
+    }
+    if (m <= 0.001f) continue;
+    uint8_t V = (uint8_t)constrain((int)(baseV * m), 0, 255);
+    uint8_t ci = reverseIndex ? (colorIndex + 64) : colorIndex;
+    led[reverseIndex ? (NUM_LEDS - 1 - i) : i] = ColorFromPalette(pal, ci, V);
+  }
+}
+
+static void randomClouds(Cloud* C, float baseSpeed) {
+  for (uint8_t i = 0; i < CLOUD_COUNT; i++) {
+    C[i].center = random16(NUM_LEDS) + random8() / 256.0f;
+    C[i].length = (float)random((long)CLOUD_MIN_LEN, (long)CLOUD_MAX_LEN);
+    C[i].speed  = baseSpeed * (0.7f + (random8() / 255.0f) * 0.6f) * 4;
+    C[i].wobble = random16();
+  }
+}
+
+int main(int argc, char** argv) {
+  int frames = 4000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--frames N]\n", argv[0]); return 2; }
+  }
+
+  static CRGB fixedOut[NUM_LEDS], refOut[NUM_LEDS];
+  static CloudField fixedC;
+  Cloud refC[CLOUD_COUNT];
+  hostSetMicros(1000000);
+  random16_set_seed(7);
+
+  int worst = 0;
+  uint32_t diffPixels = 0, litPixels = 0, floorSteps = 0;
+  double fixedUs = 0, refUs = 0;
+
+  // the palette LUT must match ColorFromPalette exactly at every brightness
+  static PaletteLut luts[MUSIC_PALETTE_COUNT];
+  uint32_t lutMismatches = 0;
+  for (uint8_t p = 0; p < MUSIC_PALETTE_COUNT; p++) {
+    luts[p].build(musicPalettes[p]);
+    for (int idx = 0; idx < 256; idx++)
+      for (int v = 0; v < 256; v++)
+        if (luts[p].at((uint8_t)idx, (uint8_t)v) != ColorFromPalette(musicPalettes[p], (uint8_t)idx, (uint8_t)v))
+          ++lutMismatches;
+  }
+  printf("palette lut mismatches=%u\n", lutMismatches);
+
+  for (int f = 0; f < frames; f++) {
+    if (f % 100 == 0) {
+      randomClouds(refC, (f / 100) & 1 ? CLOUD_SPEED_2 : CLOUD_SPEED_1);
+      settings.cloudEdgeKnob = (uint8_t)(10 + (f / 100) * 13 % 191);  // whole knob range
+      publishSettings();
+    }
+    hostAdvanceMicros(16667);
+    uint8_t baseV = (uint8_t)(18 + (f * 37) % 238);
+    const CRGBPalette16& pal = musicPalettes[(f / 50) % MUSIC_PALETTE_COUNT];
+    const PaletteLut& lut = luts[(f / 50) % MUSIC_PALETTE_COUNT];
+    bool rev = f & 1;
+    uint16_t t = (uint16_t)(f * 5);
+
+    auto a = std::chrono::steady_clock::now();
+    refRenderPaletteClouds(refOut, rev, pal, baseV, refC, t, t * 2, t * 3);   // moves refC too
+    auto b = std::chrono::steady_clock::now();
+    memcpy(fixedC.c, refC, sizeof(refC));                                   // same clouds, render only
+    auto c = std::chrono::steady_clock::now();
+    fixedC.render(fixedOut, rev, lut, baseV, t, t * 2, t * 3);
+    auto d = std::chrono::steady_clock::now();
+    refUs   += std::chrono::duration<double, std::micro>(b - a).count();
+    fixedUs += std::chrono::duration<double, std::micro>(d - c).count();
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+      int d = 0, peak = 0;
+      for (int ch = 0; ch < 3; ch++) {
+        d = max(d, abs((int)fixedOut[i][ch] - (int)refOut[i][ch]));
+        peak = max(peak, max((int)fixedOut[i][ch], (int)refOut[i][ch]));
+      }
+      if (refOut[i] != CRGB::Black) ++litPixels;
+      if (!d) continue;
+      ++diffPixels;
+      // V 0 <-> 1 is one brightness LSB but up to 2 per channel after
+      // ColorFromPalette's (V + 1) scaling; count it as a floor step
+      bool floorStep = (fixedOut[i] == CRGB::Black || refOut[i] == CRGB::Black) && peak <= 2;
+      if (floorStep) { ++floorSteps; continue; }
+      worst = max(worst, d);
+    }
+  }
+
+  printf("frames=%d lit=%u differing=%u (floor steps %u) worst_lsb=%d\n",
+         frames, litPixels, diffPixels, floorSteps, worst);
+  printf("float %.2f us/strip, fixed %.2f us/strip (%.2fx)\n",
+         refUs / frames, fixedUs / frames, refUs / max(1e-9, fixedUs));
+  return (worst <= 1 && lutMismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+// ============== Cloud motion vs frame rate ==============
+// Runs the real cloud path (effect -> renderCloudsPair -> CloudField::advance
+// on both strips) from the same starting clouds for 4 s (--seconds) of virtual time at
+// 30, 60 and 120 FPS, then checks that every cloud ended where its speed
+// says it should (center, mod NUM_LEDS, to within float rounding of one add
+// per frame) and that the breathing lengths agree across frame rates (to
+// within the midpoint-rule error of sampling the breath mid-step, which
+// goes as the difference of the squared steps against 60 FPS):
+//   segmentDJ   : clouds at their own speed
+//   paletteFlow : speed x the music motion factor (scene level held fixed)
+//
+//   pio run -e native_cloudfps && .pio/build/native_cloudfps/program [--seconds N]
+
+#include "../../src/main.cpp"   // single TU: the check reads main.cpp's statics
+
+static const uint32_t START_US    = 1000000;
+static const float    POS_TOL     = 0.0002f; // px, plus half a float ulp (centers < 1024) per frame
+static const float    POS_ULP     = 1.0f / 16384;
+static const float    LEN_TOL_DT2 = 1.8f;   // relative to 60 FPS, per s^2 of |dt^2 - dt60^2|
+static const float    SCENE       = 0.5f;   // g_sceneLevel during paletteFlow
+
+struct Ends { Cloud c[2][CLOUD_COUNT]; };
+
+static float wrapDist(float a, float b) {
+  float d = fabsf(fmodf(a - b, (float)NUM_LEDS));
+  return fminf(d, NUM_LEDS - d);
+}
+
+// Restores the start state, runs `fn` at fps for seconds, returns the clouds
+static Ends run(void (*fn)(), uint32_t fps, int seconds, const CloudField& s1, const CloudField& s2) {
+  clouds1 = s1; clouds2 = s2;
+  hostSetMicros(START_US);
+  frameClock.reset(micros(), millis());
+  const uint32_t frames = fps * (uint32_t)seconds;
+  for (uint32_t f = 1; f <= frames; f++) {
+    hostSetMicros(START_US + (uint64_t)f * 1000000ULL / fps);   // exact total, integer steps
+    frameClock.tick(micros());
+    g_sceneLevel = SCENE;
+    fn();
+  }
+  Ends e;
+  memcpy(e.c[0], clouds1.c, sizeof(e.c[0]));
+  memcpy(e.c[1], clouds2.c, sizeof(e.c[1]));
+  return e;
+}
+
+int main(int argc, char** argv) {
+  int seconds = 4;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--seconds N]\n", argv[0]); return 2; }
+  }
+
+  hostSetMicros(START_US);
+  setup();
+  setMusicPalette(2, 0, true);
+  publishSettings();
+  const CloudField start1 = clouds1, start2 = clouds2;
+  const float flowMotion = (0.6f + 1.0f * SCENE) * (frameSettings().cloudSpeedScale / 100.0f);
+
+  struct Effect { const char* name; void (*fn)(); float motion; };
+  const Effect effects[] = { { "segmentDJ", fx_segmentDJ, 1.0f }, { "paletteFlow", fx_paletteFlow, flowMotion } };
+  const uint32_t FPS[] = { 30, 60, 120 };
+
+  bool ok = true;
+  for (const Effect& fx : effects) {
+    Ends ends[3];
+    for (int r = 0; r < 3; r++) ends[r] = run(fx.fn, FPS[r], seconds, start1, start2);
+
+    for (int r = 0; r < 3; r++) {
+      float posErr = 0, lenErr = 0;
+      for (int s = 0; s < 2; s++) {
+        const Cloud* c0 = s ? start2.c : start1.c;
+        for (uint8_t k = 0; k < CLOUD_COUNT; k++) {
+          float want = c0[k].center + c0[k].speed * fx.motion * seconds;
+          posErr = fmaxf(posErr, wrapDist(ends[r].c[s][k].center, want));
+          lenErr = fmaxf(lenErr, fabsf(ends[r].c[s][k].length / ends[1].c[s][k].length - 1.0f));
+        }
+      }
+      const uint32_t frames = FPS[r] * (uint32_t)seconds;
+      const float    dt = 1.0f / FPS[r], dt60 = 1.0f / 60;
+      bool pass = posErr <= POS_TOL + frames * POS_ULP * 0.5f && lenErr <= LEN_TOL_DT2 * fabsf(dt * dt - dt60 * dt60);
+      ok &= pass;
+      printf("%-11s %3u FPS %4u frames  center err %.5f px  length vs 60 FPS %.4f%%  %s\n", fx.name,
+             (unsigned)FPS[r], (unsigned)frames, posErr, lenErr * 100.0f, pass ? "PASS" : "FAIL");
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// ============== Compositor equivalence check ==============
+// Random layer stacks over random strips, composited twice: once the old
+// way (one full pass per layer with nblend / nscale8_video / fadeToBlackBy,
+// bottom to top, no-op layers included) and once through Compositor::apply.
+// The two buffers must match byte for byte on every path: one layer, two
+// layers, 3+ layers and the opaque fold.
+//
+//   pio run -e native_compositor && .pio/build/native_compositor/program [--stacks N]
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "compositor.h"
+
+static const uint16_t N = 600;
+
+enum Path : uint8_t { P_NONE, P_ONE, P_TWO, P_DEEP, P_OPAQUE, P_COUNT };
+static const char* const PATH_NAMES[P_COUNT] = { "empty", "1-layer", "2-layer", "3+-layer", "opaque" };
+
+// Mostly the edges the compositor special-cases, the rest anywhere.
+static uint8_t randOpacity() {
+  switch (random(8)) {
+    case 0:  return 0;
+    case 1:  return 255;
+    case 2:  return (uint8_t)random(1, 4);
+    case 3:  return (uint8_t)random(252, 255);
+    default: return (uint8_t)random(256);
+  }
+}
+
+static CRGB randColor() {
+  switch (random(4)) {
+    case 0:  return CRGB::Black;
+    case 1:  return CRGB((uint8_t)(random(2) * 255), (uint8_t)(random(2) * 255), (uint8_t)(random(2) * 255));
+    default: return CRGB((uint8_t)random(256), (uint8_t)random(256), (uint8_t)random(256));
+  }
+}
+
+// The legacy overlay: one full pass per layer, in order.
+static void reference(CRGB* px, uint16_t n, uint8_t s, const Layer* ls, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    const Layer& l = ls[i];
+    for (uint16_t p = 0; p < n; p++) {
+      if (l.mode == BM_OVER)     nblend(px[p], l.color[s], l.opacity);
+      else if (l.mode == BM_DIM) px[p].nscale8_video(l.opacity);
+      else                       px[p].fadeToBlackBy(l.opacity);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  uint32_t stacks = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--stacks") && i + 1 < argc) stacks = (uint32_t)max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--stacks N]\n", argv[0]); return 2; }
+  }
+
+  randomSeed(25);
+  static CRGB base[2][N], want[2][N], got[2][N];
+  uint32_t runs[P_COUNT] = {}, bad[P_COUNT] = {}, dropped = 0;
+
+  for (uint32_t k = 0; k < stacks; k++) {
+    Layer ls[Compositor::MAX_LAYERS];
+    const uint8_t count = (uint8_t)random(1, Compositor::MAX_LAYERS + 1);
+    Compositor comp;
+    for (uint8_t i = 0; i < count; i++) {
+      ls[i] = { (BlendMode)random(3), randOpacity(), { randColor(), randColor() } };
+      comp.add(ls[i].mode, ls[i].opacity, ls[i].color[0], ls[i].color[1]);
+    }
+    dropped += count - comp.count();
+
+    const Path path = comp.coversBase() ? P_OPAQUE
+                    : comp.count() == 0 ? P_NONE
+                    : comp.count() == 1 ? P_ONE
+                    : comp.count() == 2 ? P_TWO : P_DEEP;
+    runs[path]++;
+
+    bool same = true;
+    for (uint8_t s = 0; s < 2; s++) {
+      for (uint16_t p = 0; p < N; p++) base[s][p] = randColor();
+      memcpy(want[s], base[s], sizeof(want[s]));
+      memcpy(got[s], base[s], sizeof(got[s]));
+      reference(want[s], N, s, ls, count);
+      comp.apply(got[s], N, s);
+      if (memcmp(want[s], got[s], sizeof(want[s]))) same = false;
+    }
+    if (!same && bad[path]++ < 5) {
+      fprintf(stderr, "stack %u (%s) differs:", (unsigned)k, PATH_NAMES[path]);
+      for (uint8_t i = 0; i < count; i++) fprintf(stderr, " %d/%u", ls[i].mode, ls[i].opacity);
+      fprintf(stderr, "\n");
+    }
+  }
+
+  uint32_t failures = 0;
+  for (uint8_t p = 0; p < P_COUNT; p++) {
+    printf("%-9s %6u stacks  %u differ\n", PATH_NAMES[p], (unsigned)runs[p], (unsigned)bad[p]);
+    failures += bad[p];
+  }
+  // every path has to have been exercised, or a pass means nothing
+  for (uint8_t p = P_ONE; p < P_COUNT; p++)
+    if (!runs[p]) { printf("%s path never ran\n", PATH_NAMES[p]); failures++; }
+  printf("%u no-op layers dropped by add()  %s\n", (unsigned)dropped, failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
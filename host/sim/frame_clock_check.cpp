@@ -0,0 +1,109 @@
+// ============== One "now" per frame ==============
+// Runs loop() through a scripted show (bounce + jolt, flash pulse, laser
+// latch and dim fade, DJ segments, confetti, Music mode on the fake MSGEQ7,
+// strobe) twice from the same post-setup() state: once on a clock that only
+// moves between frames, and once with --cost us passing after every clock
+// read, as if the stages' own work took time. Every stage reads the frame
+// clock, so both runs must give the same strips and laser pin frame for
+// frame. Also reports how many clock reads a frame still makes (the budget's
+// stage marks).
+//
+//   pio run -e native_frameclock && .pio/build/native_frameclock/program [--cost US] [--seconds N]
+
+#include "../../src/main.cpp"   // single TU: the check pokes main.cpp's statics
+#include "scripted_bands.h"
+#include "fake_msgeq7.h"
+#include "fork_run.h"
+
+#include <vector>
+
+static const uint32_t FRAME_US = 16667;
+static const uint32_t START_US = 1000000;
+
+static FakeMsgeq7 g_chip;
+
+struct Cue { uint32_t frame; const char* keys; };
+static const Cue CUES[] = {
+  {   0, "w" },  {  60, "k" },  { 100, "f" },  { 140, "l" },   // bounce, jolt, flash, laser on
+  { 200, "e" },  { 300, "q" },  { 380, "l" },                 // DJ segments, confetti, laser off
+  { 420, "m" },  { 700, "s" },  { 760, "s" },                 // Music, strobe on / off
+};
+
+struct FrameOut { uint32_t hash; uint32_t reads; };
+
+// One pass over the show; out[f] is what frame f put on the wire.
+static void runShow(uint32_t frames, uint32_t costUs, FrameOut* out) {
+  uint64_t t = START_US;
+  for (uint32_t f = 0; f < frames; f++) {
+    const uint64_t frameStart = START_US + (uint64_t)(f + 1) * FRAME_US;
+    for (; t < frameStart; t += MSGEQ7_TICK_US) {        // the timer ISR, between frames
+      hostSetMicros(t);
+      uint8_t lv[7];
+      scriptLevels((uint32_t)(t / 1000), lv);
+      for (int b = 0; b < 7; b++) g_chip.level[b] = (uint16_t)(lv[b] * 16);
+      msgeq7.tick();
+    }
+    hostSetMicros(frameStart);
+    for (const Cue& c : CUES) if (c.frame == f) Serial.rx = c.keys;
+    if (f == 160) laserDimTarget = 64;                   // fade down with the laser on...
+    if (f == 400) laserDimTarget = 255;                  // ...and back up
+
+    const uint64_t reads0 = g_hostClockReads;
+    g_hostUsPerClockRead = costUs;
+    loop();
+    g_hostUsPerClockRead = 0;
+
+    uint32_t h = fnv(FNV_SEED, leds1, sizeof(leds1));
+    h = fnv(h, leds2, sizeof(leds2));
+    h = fnv(h, &g_hostPins.level[LASER_PIN], 1);
+    out[f] = { h, (uint32_t)(g_hostClockReads - reads0) };
+  }
+}
+
+// Runs the show in a fork of the current state and collects its frames.
+static bool forkShow(uint32_t frames, uint32_t costUs, std::vector<FrameOut>& out) {
+  std::string raw;
+  const int rc = forkRun([&](int fd) {
+    std::vector<FrameOut> o(frames);
+    runShow(frames, costUs, o.data());
+    forkWrite(fd, o.data(), o.size() * sizeof(FrameOut));
+    return 0;
+  }, &raw);
+  if (rc != 0 || raw.size() != frames * sizeof(FrameOut)) return false;
+  out.resize(frames);
+  memcpy(out.data(), raw.data(), raw.size());
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int costUs = 50, seconds = 15;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--cost") && i + 1 < argc) costUs = max(1, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--cost US] [--seconds N]\n", argv[0]); return 2; }
+  }
+  const uint32_t frames = (uint32_t)seconds * 60;
+
+  hostSetMicros(START_US);
+  g_chip.attach(STROBE_PIN, RESET_PIN, ANALOG_PIN);
+  setup();
+
+  std::vector<FrameOut> still, costly;
+  if (!forkShow(frames, 0, still) || !forkShow(frames, (uint32_t)costUs, costly)) {
+    fprintf(stderr, "show run failed\n");
+    return 2;
+  }
+
+  uint32_t differ = 0, first = UINT32_MAX, maxReads = 0;
+  uint64_t reads = 0;
+  for (uint32_t f = 0; f < frames; f++) {
+    if (still[f].hash != costly[f].hash) { differ++; first = min(first, f); }
+    reads += costly[f].reads;
+    maxReads = max(maxReads, costly[f].reads);
+  }
+  printf("%u frames, %d us per clock read: %u differ", (unsigned)frames, costUs, (unsigned)differ);
+  if (differ) printf(" (first at frame %u)", (unsigned)first);
+  printf(", clock reads per frame %.1f mean / %u max  %s\n", (double)reads / frames, (unsigned)maxReads,
+         differ ? "FAIL" : "PASS");
+  return differ ? 1 : 0;
+}
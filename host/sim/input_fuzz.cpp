@@ -0,0 +1,222 @@
+// ============== Input queue + decoder fuzz ==============
+// Three checks on the input layer (see INPUT in main.cpp):
+//   queue  : SpscQueue against a std::deque model under random push/pop, then
+//            a producer and a consumer thread passing a counter through it
+//            (every value arrives, in order, exactly once).
+//   decode : random bytes through decodeKey(); every command must be a known
+//            op with an in-range argument.
+//   frames : random key bursts, button bounces and knob noise through the
+//            real loop(). After every frame the queue must be empty and all
+//            state in range; and the same key stream split across frames
+//            differently must end in the same state (keys that depend on
+//            time - auto cycle, FPS - are left out of that stream).
+// Each frames run is a forked copy of the post-setup() process. The
+// firmware's serial log goes to stderr.
+//
+//   pio run -e native_input && .pio/build/native_input/program [--runs N] [--seed S]
+
+#include "../../src/main.cpp"   // single TU: the fuzzer pokes main.cpp's statics
+#include "fork_run.h"
+
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint32_t FRAME_US = 16667;
+static const uint32_t START_US = 1000000;
+
+static uint32_t rng = 1;
+static uint32_t rnd(uint32_t n) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng % n; }
+
+// ---------------- queue ----------------
+static bool queueModel(uint32_t ops) {
+  SpscQueue<uint32_t, 64> q;
+  std::deque<uint32_t> model;
+  uint32_t next = 0;
+  for (uint32_t i = 0; i < ops; i++) {
+    if (rnd(100) < 55) {
+      bool ok = q.push(next);
+      if (ok != (model.size() < 64)) { printf("queue: push %s at size %zu\n", ok ? "accepted" : "refused", model.size()); return false; }
+      if (ok) model.push_back(next++);
+    } else {
+      uint32_t v;
+      bool ok = q.pop(v);
+      if (ok != !model.empty() || (ok && v != model.front())) { printf("queue: pop mismatch at op %u\n", i); return false; }
+      if (ok) model.pop_front();
+    }
+    if (q.size() != model.size() || q.space() != 64 - model.size()) { printf("queue: size mismatch at op %u\n", i); return false; }
+  }
+  return true;
+}
+
+static bool queueThreads(uint32_t count, uint64_t& fullSpins) {
+  static SpscQueue<uint32_t, 64> q;
+  std::atomic<uint64_t> spins{0};
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < count; i++)
+      while (!q.push(i)) { spins.fetch_add(1, std::memory_order_relaxed); std::this_thread::yield(); }
+  });
+  bool ok = true;
+  for (uint32_t want = 0; want < count; ) {
+    uint32_t v;
+    if (!q.pop(v)) { std::this_thread::yield(); continue; }
+    if (v != want) { printf("queue: thread got %u, expected %u\n", v, want); ok = false; break; }
+    want++;
+  }
+  producer.join();
+  fullSpins = spins.load();
+  return ok;
+}
+
+// ---------------- decoder ----------------
+static bool decodeFuzz(uint32_t bytes, uint32_t& cmds) {
+  static const char biased[] = "\x1b\x1b[[ABCDabcdegkmnoprstuwxGLNPZ0123456789+-";
+  escState = ESC_IDLE;
+  for (uint32_t i = 0; i < bytes; i++) {
+    char c = rnd(2) ? (char)rnd(256) : biased[rnd(sizeof(biased) - 1)];
+    InputCmd in;
+    if (!decodeKey(c, in)) continue;
+    cmds++;
+    bool ok = in.op < IN_BUTTON && (in.flags & ~INF_WAKES) == 0;
+    if (in.op == IN_ARROW)      ok = ok && in.arg >= 'A' && in.arg <= 'D' && !(in.flags & INF_WAKES);
+    if (in.op == IN_PALETTE)    ok = ok && in.arg < 9;
+    if (in.op == IN_EFFECT)     ok = ok && in.arg < FX_COUNT;
+    if (in.op == IN_TAP)        ok = ok && in.arg < 2 && in.value >= 0 && in.value <= 1;
+    if (in.op == IN_PARAM_STEP) ok = ok && in.arg < P_COUNT && abs(in.value) == 1;
+    if (!ok) { printf("decode: byte 0x%02x -> op %u arg %u flags %u value %d\n", (uint8_t)c, in.op, in.arg, in.flags, in.value); return false; }
+  }
+  return true;
+}
+
+// ---------------- frames ----------------
+static const uint8_t BTN_PINS[8] = { BTN_A, BTN_B, BTN_C, BTN_D, BTN_E, BTN_F, BTN_G, BTN_H };
+
+static std::string stateLine() {
+  char b[256];
+  snprintf(b, sizeof(b), "mode=%d fx=%d pal=%u arrow=%u gates=%d/%d/%d/%d flash=%u strobe=%u bright=%u laser=%d strobeKey=%d blackout=%d cursors=%d/%d",
+           currentMode, currentEffect, settings.palette, arrowMode, settings.musicGate, settings.bassGate, settings.trebleGate,
+           settings.laserGate, settings.flashSet, settings.strobeSet, FastLED.getBrightness(), laserOn, strobeFromKey, blackoutActive,
+           bassCursor, trebleCursor);
+  return b;
+}
+
+static const char* checkFrame() {
+  if (inputQueue.size())                                          return "queue not drained at frame end";
+  if (currentEffect < 0 || currentEffect >= FX_COUNT)             return "effect out of range";
+  if (settings.palette >= MUSIC_PALETTE_COUNT)                   return "palette out of range";
+  if (arrowMode >= ARROW_MODE_COUNT)                              return "arrow mode out of range";
+  if (settings.flashSet >= FLASH_SET_COUNT || settings.strobeSet >= STROBE_SET_COUNT) return "colour set out of range";
+  if (settings.musicGate < 0 || settings.musicGate > 900 || settings.bassGate < 0 || settings.bassGate > 900 ||
+      settings.trebleGate < 0 || settings.trebleGate > 900 || settings.laserGate < 0 || settings.laserGate > 900) return "gate out of range";
+  if (TARGET_FPS < 20 || TARGET_FPS > 120)                        return "target FPS out of range";
+  if (ui > UI_FX_TWEAK)                                           return "ui screen out of range";
+  for (uint8_t i = 0; i < 8; i++)
+    if (BTN[i].pressed != btnDebounce[i].sent)                    return "button state differs from what was queued";
+  return nullptr;
+}
+
+// Feeds `keys` over `frames` frames, `split[f]` bytes offered at frame f (the
+// rest carry over, like a UART FIFO). noise: bounce buttons and wiggle knobs.
+static const char* runFrames(const std::string& keys, const std::vector<uint32_t>& split, bool noise, std::string& state) {
+  std::string pending;
+  size_t at = 0;
+  for (size_t f = 0; f < split.size() || !pending.empty(); f++) {
+    if (f < split.size()) { pending.append(keys, at, split[f]); at += split[f]; }
+    if (noise) {
+      for (uint8_t i = 0; i < 8; i++) if (!rnd(40)) g_hostPins.level[BTN_PINS[i]] ^= 1;
+      g_hostAnalog[POT1_PIN] = (uint16_t)constrain((int)g_hostAnalog[POT1_PIN] + (int)rnd(200) - 100, 0, 4095);
+      g_hostAnalog[POT2_PIN] = (uint16_t)constrain((int)g_hostAnalog[POT2_PIN] + (int)rnd(200) - 100, 0, 4095);
+      g_hostTouch[EFFECT_PIN] = rnd(30) ? 0 : 10;
+    }
+    Serial.rx = pending.c_str();
+    hostAdvanceMicros(FRAME_US);
+    loop();
+    pending.erase(0, Serial.rx - pending.c_str());
+    Serial.rx = nullptr;
+    if (const char* err = checkFrame()) return err;
+    if (f > split.size() + 10000) return "keys never drained";
+  }
+  state = stateLine();
+  return nullptr;
+}
+
+// Runs the frames in a child; out is "OK <state>" or "ERR <why>".
+static bool forkFrames(const std::string& keys, const std::vector<uint32_t>& split, bool noise, uint32_t childSeed, std::string& out) {
+  const int rc = forkRun([&](int fd) {
+    rng = childSeed;
+    std::string state;
+    const char* err = runFrames(keys, split, noise, state);
+    const std::string msg = err ? std::string("ERR ") + err : "OK " + state;
+    forkWrite(fd, msg.data(), msg.size());
+    return 0;
+  }, &out);
+  if (rc != 0) { out = "ERR child crashed"; return false; }
+  return out.compare(0, 3, "OK ") == 0;
+}
+
+static std::vector<uint32_t> randomSplit(size_t total, uint32_t frames) {
+  std::vector<uint32_t> s(frames, 0);
+  for (size_t i = 0; i < total; i++) s[rnd(frames)]++;
+  return s;
+}
+
+int main(int argc, char** argv) {
+  uint32_t runs = 40, seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if      (!strcmp(argv[i], "--runs") && i + 1 < argc) runs = (uint32_t)max(1, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--runs N] [--seed S]\n", argv[0]); return 2; }
+  }
+  rng = seed;
+  bool ok = true;
+
+  bool q1 = queueModel(2000000);
+  uint64_t spins = 0;
+  bool q2 = queueThreads(2000000, spins);
+  printf("queue : model 2M ops %s, 2 threads 2M values %s (producer saw full %llu times)\n",
+         q1 ? "PASS" : "FAIL", q2 ? "PASS" : "FAIL", (unsigned long long)spins);
+  ok &= q1 && q2;
+
+  uint32_t cmds = 0;
+  bool d = decodeFuzz(2000000, cmds);
+  printf("decode: 2M bytes -> %u commands %s\n", cmds, d ? "PASS" : "FAIL");
+  ok &= d;
+
+  hostSetMicros(START_US);
+  setup();
+  fflush(stdout);
+
+  // keys whose effect doesn't depend on when they land
+  static const char timeless[] = "\x1b[ABCD\x1b[A\x1b[Bbcdefgklmnopqrstwx0123456789BCEFGKLMNOPQRSTWX\x1b";
+  static const char anything[] = "\x1b[ABCD\x1b[A\x1b[Babcdefgklmnopqrstuwxz0123456789+-ABCDEFGKLMNOPQRSTUWXZ";
+  uint32_t split = 0, fuzz = 0;
+  for (uint32_t r = 0; r < runs; r++) {
+    const uint32_t frames = 120 + rnd(240);
+    std::string keys;
+    size_t len = rnd(frames * 3);
+    for (size_t i = 0; i < len; i++) keys += timeless[rnd(sizeof(timeless) - 1)];
+
+    // same stream: one frame per byte-ish vs random bursts
+    std::string a, b;
+    std::vector<uint32_t> even(frames, 0);
+    for (size_t i = 0; i < len; i++) even[i * frames / max<size_t>(len, 1)]++;
+    bool okA = forkFrames(keys, even, false, rng, a);
+    bool okB = forkFrames(keys, randomSplit(len, frames), false, rng, b);
+    if (!okA || !okB || a != b) {
+      printf("frames: run %u split mismatch\n  even : %s\n  burst: %s\n", r, a.c_str(), b.c_str());
+      ok = false;
+    } else split++;
+
+    // anything goes, plus button/knob/touch noise
+    std::string c;
+    std::string noisy;
+    for (size_t i = 0; i < len; i++) noisy += anything[rnd(sizeof(anything) - 1)];
+    if (!forkFrames(noisy, randomSplit(len, frames), true, rng + 7, c)) {
+      printf("frames: run %u noise: %s\n", r, c.c_str());
+      ok = false;
+    } else fuzz++;
+  }
+  printf("frames: %u runs, split-invariant %u/%u, noisy %u/%u %s\n", runs, split, runs, fuzz, runs, ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
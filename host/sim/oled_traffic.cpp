@@ -0,0 +1,86 @@
+// ============== OLED bus traffic under UI load ==============
+// Drives loop() on the virtual 60 FPS clock with scripted serial keys and
+// plays oledTask's part by calling serviceOled() between passes, counting
+// the I2C bytes the Wire shim sees on each side:
+//   storm  : an effect key every frame (home screen changes every frame)
+//   burst  : 8 keys per frame, like key repeat backed up in the UART FIFO
+//   toggle : an effect key every 4 frames
+//   idle   : no input
+// Fails if loop() itself puts anything on the bus, if the HUD is composed
+// more than once per frame, if flushes come faster than OLED_MAX_HZ, or if
+// the panel doesn't end on the last drawn screen.
+//
+//   pio run -e native_oled && .pio/build/native_oled/program [--seconds N]
+
+#include "../../src/main.cpp"   // single TU: the harness pokes main.cpp's statics
+
+static const uint32_t FRAME_US = 16667;
+static const uint32_t START_US = 1000000;
+
+struct Scenario { const char* name; const char* keys; uint8_t every, perFrame; };
+
+static bool run(const Scenario& sc, int seconds) {
+  const uint32_t frames = (uint32_t)seconds * 60;
+  uint32_t loopBytes = 0, flushBytes = 0, flushes = 0, minGapMs = UINT32_MAX, lastFlushMs = 0;
+  const uint32_t pages0 = oledPagesPushed, full0 = display.pushes, redraws0 = hudRedraws;
+  char keys[16] = {};
+  size_t k = 0;
+
+  for (uint32_t f = 0; f < frames; f++) {
+    hostAdvanceMicros(FRAME_US);
+    if (sc.keys && f % sc.every == 0) {
+      for (uint8_t i = 0; i < sc.perFrame; i++) keys[i] = sc.keys[k++ % strlen(sc.keys)];
+      keys[sc.perFrame] = 0;
+      Serial.rx = keys;
+    }
+    uint32_t b0 = Wire.bytes;
+    loop();
+    loopBytes += Wire.bytes - b0;
+
+    b0 = Wire.bytes;
+    uint32_t last0 = oledLastFlushMs, now = millis();
+    serviceOled(now);
+    if (oledLastFlushMs != last0) {
+      if (flushes++) minGapMs = min(minGapMs, now - lastFlushMs);
+      lastFlushMs = now;
+    }
+    flushBytes += Wire.bytes - b0;
+  }
+  publishOled();                                       // the last frame's screen, as the next pass would
+  hostAdvanceMicros(OLED_MIN_MS * 1000);
+  serviceOled(millis());
+
+  const uint32_t pages   = oledPagesPushed - pages0;
+  const uint32_t redraws = hudRedraws - redraws0;
+  const bool settled = !oledDiff(oledShown, oled.screen());
+  const bool paced   = flushes < 2 || minGapMs >= OLED_MIN_MS;
+  const bool ok      = loopBytes == 0 && display.pushes == full0 && redraws <= frames && paced && settled;
+  printf("%-7s %5u frames %4u HUD redraws | %4u flushes (min gap %4u ms) %5u pages %7u B  bus %6.1f ms/s | in loop() %u B | %s%s%s\n",
+         sc.name, (unsigned)frames, (unsigned)redraws, (unsigned)flushes, flushes > 1 ? (unsigned)minGapMs : 0, (unsigned)pages,
+         (unsigned)flushBytes, flushBytes * 9 / 400.0 / seconds,
+         (unsigned)loopBytes, ok ? "PASS" : "FAIL", settled ? "" : " (panel stale)", paced ? "" : " (over rate)");
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  int seconds = 10;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--seconds N]\n", argv[0]); return 2; }
+  }
+
+  hostSetMicros(START_US);
+  setup();
+  fflush(stdout);
+
+  const Scenario scenarios[] = {
+    { "storm",  "qwre",   1, 1 },
+    { "burst",  "qwreq",  1, 8 },
+    { "toggle", "qw",     4, 1 },
+    { "idle",   nullptr,  1, 1 },
+  };
+  printf("OLED_MAX_HZ=%u, bus at 400 kHz (9 bits/byte)\n", (unsigned)OLED_MAX_HZ);
+  bool ok = true;
+  for (const Scenario& sc : scenarios) ok &= run(sc, seconds);
+  return ok ? 0 : 1;
+}
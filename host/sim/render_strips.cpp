@@ -0,0 +1,241 @@
+// ============== Headless strip renderer + golden-image check ==============
+// Runs an effect (fx_paletteFlow or any FX[] entry) for N frames on the
+// virtual 60 FPS clock with the scripted bands from the bench, and writes
+//   OUT/<name>.ppm  space-time image: one row per frame,
+//                   strip 1 | 4 px gap | strip 2 (pixel 0 on the left)
+//   OUT/<name>.rgb  raw stream: per frame leds1 then leds2, 600 x RGB8 each
+//
+// Golden check: --update copies the images into GOLDEN; without it every
+// image is compared with GOLDEN/<name>.ppm. A pixel is "off" when any
+// channel differs by more than --tol; the case fails when more than
+// --max-bad percent of pixels are off. Failing cases also get
+// OUT/<name>.diff.ppm (|a-b| x16). Typical use around a refactor:
+//   before: program --update        after: program
+//
+// Each case runs in a forked copy of the post-setup() process, so function
+// statics inside the effects start fresh every time. --threads 2 renders the
+// strips on two threads (stripFork) - the images must not change.
+//
+// OUT (and GOLDEN with --update) are created as needed. Exit status: 0 all
+// cases pass, 1 a case failed, 2 usage or I/O error - the run stops at the
+// first file it can't write.
+//
+//   pio run -e native_render && .pio/build/native_render/program [--fx NAME] [--frames N]
+//       [--out DIR] [--golden DIR] [--update] [--tol LSB] [--max-bad PCT] [--threads 2]
+
+#include "../../src/main.cpp"   // single TU: the renderer pokes main.cpp's statics
+#include "scripted_bands.h"
+#include "fork_run.h"
+
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t FRAME_US = 16667;
+static const uint32_t START_US = 1000000;
+static const int      GAP_PX   = 4;
+static const int      IMG_W    = NUM_LEDS * 2 + GAP_PX;
+
+struct RenderCase {
+  std::string name;
+  uint8_t     palette;
+  bool        spawnSegments;   // DJ-style segments from scripted "keys"
+  void      (*fn)();
+};
+
+struct Image {
+  int w = 0, h = 0;
+  std::vector<uint8_t> px;
+};
+
+static bool writePpm(const std::string& path, const Image& img) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) { fprintf(stderr, "can't write %s\n", path.c_str()); return false; }
+  fprintf(f, "P6\n%d %d\n255\n", img.w, img.h);
+  fwrite(img.px.data(), 1, img.px.size(), f);
+  fclose(f);
+  return true;
+}
+
+// mkdir -p; false (with a message) if DIR can't be made or written to.
+static bool makeDirs(const std::string& dir) {
+  for (size_t i = 1; i <= dir.size(); i++)
+    if (i == dir.size() || dir[i] == '/') mkdir(dir.substr(0, i).c_str(), 0755);
+  if (access(dir.c_str(), W_OK) == 0) return true;
+  fprintf(stderr, "can't write to %s: %s\n", dir.c_str(), strerror(errno));
+  return false;
+}
+
+static bool readPpm(const std::string& path, Image& img) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  int maxv = 0;
+  bool ok = fscanf(f, "P6 %d %d %d", &img.w, &img.h, &maxv) == 3 && maxv == 255 && fgetc(f) != EOF;
+  if (ok) {
+    img.px.resize((size_t)img.w * img.h * 3);
+    ok = fread(img.px.data(), 1, img.px.size(), f) == img.px.size();
+  }
+  fclose(f);
+  return ok;
+}
+
+static void putStrip(uint8_t* row, const CRGB* strip) {
+  for (int i = 0; i < NUM_LEDS; i++) {
+    row[i * 3 + 0] = strip[i].r;
+    row[i * 3 + 1] = strip[i].g;
+    row[i * 3 + 2] = strip[i].b;
+  }
+}
+
+static void render(const RenderCase& c, int frames, Image& img, FILE* raw) {
+  hostSetMicros(START_US);
+  frameClock.reset(micros(), millis());
+  seedEffects(1337);
+  setMusicPalette(c.palette, 0, true);
+  publishSettings();
+
+  img.w = IMG_W;
+  img.h = frames;
+  img.px.assign((size_t)img.w * img.h * 3, 0);
+  for (int f = 0; f < frames; f++) {
+    hostAdvanceMicros(FRAME_US);
+    frameClock.tick(micros());     // what loop() does before any stage runs
+    scriptBands(millis());
+    if (c.spawnSegments && f % 6 == 0) {
+      bool bass = (f / 6) & 1;
+      spawnSegmentStrong((f * 37) % NUM_LEDS, bass ? BASS_SEG_LEN : TREB_SEG_LEN, bass, 230);
+    }
+    c.fn();
+
+    uint8_t* row = &img.px[(size_t)f * img.w * 3];
+    putStrip(row, leds1);
+    for (int g = 0; g < GAP_PX; g++) row[(NUM_LEDS + g) * 3 + 0] = row[(NUM_LEDS + g) * 3 + 1] = row[(NUM_LEDS + g) * 3 + 2] = 64;
+    putStrip(row + (NUM_LEDS + GAP_PX) * 3, leds2);
+    if (raw) {
+      fwrite(leds1, sizeof(CRGB), NUM_LEDS, raw);
+      fwrite(leds2, sizeof(CRGB), NUM_LEDS, raw);
+    }
+  }
+}
+
+// Returns true when within tolerance; fills the diff image.
+static bool compareImages(const Image& a, const Image& b, uint8_t tol, double maxBadPct, Image& diff, char* report, size_t reportLen) {
+  if (a.w != b.w || a.h != b.h) {
+    snprintf(report, reportLen, "size %dx%d vs golden %dx%d", a.w, a.h, b.w, b.h);
+    return false;
+  }
+  diff.w = a.w; diff.h = a.h;
+  diff.px.assign(a.px.size(), 0);
+  uint32_t bad = 0, worst = 0;
+  int firstRow = -1, firstCol = -1;
+  for (size_t p = 0; p < a.px.size(); p += 3) {
+    uint32_t m = 0;
+    for (int ch = 0; ch < 3; ch++) {
+      uint32_t d = (uint32_t)abs((int)a.px[p + ch] - (int)b.px[p + ch]);
+      diff.px[p + ch] = (uint8_t)min<uint32_t>(255, d * 16);
+      m = max(m, d);
+    }
+    worst = max(worst, m);
+    if (m > tol) {
+      if (!bad++) { firstRow = (int)(p / 3 / a.w); firstCol = (int)(p / 3 % a.w); }
+    }
+  }
+  double pct = 100.0 * bad / (a.px.size() / 3);
+  snprintf(report, reportLen, "worst %u LSB, %u px over tol (%.3f%%)", (unsigned)worst, (unsigned)bad, pct);
+  if (bad) {
+    size_t n = strlen(report);
+    bool strip2 = firstCol >= NUM_LEDS + GAP_PX;
+    snprintf(report + n, reportLen - n, ", first at frame %d strip %d px %d", firstRow, strip2 ? 2 : 1,
+             strip2 ? firstCol - NUM_LEDS - GAP_PX : firstCol);
+  }
+  return pct <= maxBadPct;
+}
+
+static std::string slug(const char* s) {
+  std::string out;
+  for (; *s; s++) {
+    char c = *s;
+    if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    out += (c == ' ' || c == '/') ? '-' : c;
+  }
+  return out;
+}
+
+int main(int argc, char** argv) {
+  const char* only = nullptr;
+  int frames = 240;
+  std::string outDir = "render", goldenDir = "host/golden";
+  bool update = false;
+  int tol = 2;
+  double maxBad = 0.0;
+  int threads = 1;
+
+  for (int i = 1; i < argc; i++) {
+    if      (!strcmp(argv[i], "--fx")      && i + 1 < argc) only = argv[++i];
+    else if (!strcmp(argv[i], "--frames")  && i + 1 < argc) frames = max(1, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--out")     && i + 1 < argc) outDir = argv[++i];
+    else if (!strcmp(argv[i], "--golden")  && i + 1 < argc) goldenDir = argv[++i];
+    else if (!strcmp(argv[i], "--tol")     && i + 1 < argc) { tol = atoi(argv[++i]); tol = constrain(tol, 0, 255); }
+    else if (!strcmp(argv[i], "--max-bad") && i + 1 < argc) maxBad = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]) > 1 ? 2 : 1;
+    else if (!strcmp(argv[i], "--update")) update = true;
+    else {
+      fprintf(stderr, "usage: %s [--fx NAME] [--frames N] [--out DIR] [--golden DIR] [--update] [--tol LSB] [--max-bad PCT] [--threads 2]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<RenderCase> cases;
+  cases.push_back({ "paletteflow",      2,                  false, fx_paletteFlow });
+  cases.push_back({ "paletteflow-dark", DARK_PALETTE_INDEX, false, fx_paletteFlow });
+  for (int i = 0; i < FX_COUNT; i++)
+    cases.push_back({ "fx-" + slug(FX[i].name), 2, FX[i].fn == fx_segmentDJ, FX[i].fn });
+
+  if (!makeDirs(outDir) || (update && !makeDirs(goldenDir))) return 2;
+
+  hostSetMicros(START_US);
+  setup();
+  fflush(stdout);
+
+  int failed = 0, ran = 0;
+  for (const RenderCase& c : cases) {
+    if (only && c.name.find(only) == std::string::npos) continue;
+    ran++;
+    const int status = forkRun([&](int) {
+      if (threads > 1) stripFork.begin();          // after fork(): the worker belongs to this case
+      std::string base = outDir + "/" + c.name;
+      FILE* raw = fopen((base + ".rgb").c_str(), "wb");
+      if (!raw) { fprintf(stderr, "can't write %s.rgb\n", base.c_str()); return 2; }
+      Image img;
+      render(c, frames, img, raw);
+      fclose(raw);
+      if (!writePpm(base + ".ppm", img)) return 2;
+
+      std::string golden = goldenDir + "/" + c.name + ".ppm";
+      int rc = 0;
+      if (update) {
+        rc = writePpm(golden, img) ? 0 : 2;
+        printf("%-20s %4d frames  golden updated\n", c.name.c_str(), frames);
+      } else {
+        Image ref, diff;
+        char report[160];
+        if (!readPpm(golden, ref)) {
+          printf("%-20s %4d frames  no golden (%s), run with --update\n", c.name.c_str(), frames, golden.c_str());
+          rc = 1;
+        } else {
+          bool ok = compareImages(img, ref, (uint8_t)tol, maxBad, diff, report, sizeof(report));
+          printf("%-20s %4d frames  %s  %s\n", c.name.c_str(), frames, ok ? "PASS" : "FAIL", report);
+          if (!ok && diff.w) writePpm(base + ".diff.ppm", diff);
+          rc = ok ? 0 : 1;
+        }
+      }
+      return rc;
+    });
+    if (status == 2) return 2;                   // I/O error: the rest would fail too
+    if (status != 0) failed++;
+  }
+  if (!ran) { fprintf(stderr, "no case matches '%s'\n", only); return 2; }
+  return failed ? 1 : 0;
+}
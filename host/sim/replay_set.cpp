@@ -0,0 +1,235 @@
+// ============== Recorded-set replay ==============
+// Feeds a raw band capture (record.py / 'x' key: TLM_TYPE_RAW packets, any
+// other bytes in the file are skipped) through the real firmware: the fake
+// MSGEQ7 is set to each recorded frame at its recorded time, the engine is
+// ticked every 40 us and loop() runs in Music mode on the virtual clock, so
+// the normalization, gating, segment spawning and laser strobe are exactly
+// the device's. Runs much faster than real time.
+//
+// Each tuning is the cross product of the lists given (defaults = the
+// firmware's values) and runs in a forked copy of the post-setup() process,
+// so no state - including function statics - leaks from one run to the next.
+// Without a file a synthetic 90 s set is used.
+//
+// Effects draw from FxRng streams seeded with --seed (the "FX seed" a device
+// logs at boot, default the host's), and every row carries a hash of all the
+// frames it rendered: same set + tuning + seed must give the same hash.
+// --twice replays each tuning twice and fails if the hashes differ.
+//
+//   pio run -e native_replay && .pio/build/native_replay/program [set.bin]
+//       [--bass 120,150,...] [--treble ...] [--laser ...]
+//       [--floor-up 0.002,...] [--crest-decay 0.0025,...] [--palette N]
+//       [--seed S] [--twice] [--csv]
+
+#include "../../src/main.cpp"   // single TU: the replay pokes main.cpp's statics
+#include "fake_msgeq7.h"
+#include "fork_run.h"
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+static const uint64_t START_US = 1000000;
+
+struct Tuning { int bass, treble, laser; float floorUp, crestDecay; };
+
+struct RunStats {
+  uint32_t frames = 0, bassHits = 0, trebleHits = 0, laserTriggers = 0, evictions = 0;
+  uint32_t frameHash = FNV_SEED;      // FNV-1a over both strips, every rendered frame
+  double   mean = 0, p99 = 0, max = 0, speed = 0;
+};
+
+static bool loadSet(const char* path, std::vector<RawBandsFrame>& out, uint32_t& lost, uint32_t& bad) {
+  FILE* f = fopen(path, "rb");
+  if (!f) { fprintf(stderr, "can't open %s\n", path); return false; }
+  TlmStreamDecoder rx;
+  rx.feed(0);                                   // a capture may start mid-packet
+  int c;
+  while ((c = fgetc(f)) != EOF) {
+    size_t n = rx.feed((uint8_t)c);
+    RawBandsFrame r;
+    if (!n || !decodeRawBands(rx.payload(), n, r)) continue;
+    if (!out.empty()) lost += (uint16_t)(r.seq - out.back().seq - 1);
+    out.push_back(r);
+  }
+  fclose(f);
+  bad = rx.bad();
+  return true;
+}
+
+// 90 s: quiet room, 124 BPM groove, 8-bar breakdown, groove again.
+static void syntheticSet(std::vector<RawBandsFrame>& out) {
+  randomSeed(21);
+  uint32_t us = 5000000;
+  for (uint16_t i = 0; i < 90 * 60; i++) {
+    float t = i / 60.0f;
+    bool groove = (t >= 10 && t < 50) || t >= 65;
+    float beat = fmodf(t * 124.0f / 60.0f, 1.0f);
+    float kick = groove ? expf(-beat * 10.0f) : 0;
+    float hat  = (t >= 10) ? expf(-fmodf(beat + 0.5f, 1.0f) * 18.0f) : 0;
+    float pad  = (t >= 50 && t < 65) ? 0.5f + 0.3f * sinf(t * 1.3f) : 0.2f;
+    RawBandsFrame r;
+    r.seq = i;
+    r.us  = us;
+    for (int b = 0; b < 7; b++) {
+      float v = (b == 0 ? 480 : 200) + random(0, 80);        // hum + noise
+      if (b <= 1) v += 3200 * kick;
+      else if (b <= 4) v += 1800 * pad + 500 * kick;
+      else v += 2400 * hat;
+      r.raw[b] = (uint16_t)constrain((int)v, 0, 4095);
+    }
+    out.push_back(r);
+    us += 16667 + random(-400, 400);                        // loop jitter as recorded
+  }
+}
+
+static FakeMsgeq7 g_chip;
+
+static RunStats replay(const std::vector<RawBandsFrame>& set, const Tuning& tn) {
+  settings.bassGate   = tn.bass;
+  settings.trebleGate = tn.treble;
+  settings.laserGate  = tn.laser;
+  BandTuning bt = bandAnalyzer.tuning();
+  bt.floorUp    = tn.floorUp;
+  bt.crestDecay = tn.crestDecay;
+  bandAnalyzer.setTuning(bt);
+
+  RunStats st;
+  std::vector<double> us;
+  us.reserve(set.size());
+  unsigned long lastBass = lastBassHitMs, lastTreble = lastTrebleHitMs, lastLaser = lastLaserTrigger;
+  const uint32_t evict0 = segments.evictions();
+  const uint64_t t0 = g_hostMicros;
+  auto wall0 = std::chrono::steady_clock::now();
+
+  for (const RawBandsFrame& r : set) {
+    for (int b = 0; b < 7; b++) g_chip.level[b] = r.raw[b];
+    const uint64_t until = t0 + (uint32_t)(r.us - set.front().us);
+    while (g_hostMicros < until) {
+      hostAdvanceMicros(MSGEQ7_TICK_US);
+      msgeq7.tick();
+      uint32_t f0 = frameBudget.frames();
+      auto a = std::chrono::steady_clock::now();
+      loop();
+      if (frameBudget.frames() == f0) continue;             // paced out, like the device spinning
+      auto b = std::chrono::steady_clock::now();
+      us.push_back(std::chrono::duration<double, std::micro>(b - a).count());
+      st.frameHash = fnv(fnv(st.frameHash, leds1, sizeof(leds1)), leds2, sizeof(leds2));
+
+      if (lastBassHitMs    != lastBass)   { st.bassHits++;      lastBass   = lastBassHitMs; }
+      if (lastTrebleHitMs  != lastTreble) { st.trebleHits++;    lastTreble = lastTrebleHitMs; }
+      if (lastLaserTrigger != lastLaser)  { st.laserTriggers++; lastLaser  = lastLaserTrigger; }
+    }
+  }
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+  st.frames    = (uint32_t)us.size();
+  st.evictions = segments.evictions() - evict0;
+  st.speed     = (g_hostMicros - t0) / 1e6 / max(wall, 1e-9);
+  if (!us.empty()) {
+    std::vector<double> s = us;
+    std::sort(s.begin(), s.end());
+    double sum = 0;
+    for (double v : s) sum += v;
+    st.mean = sum / s.size();
+    st.p99  = s[min(s.size() - 1, (s.size() * 99) / 100)];
+    st.max  = s.back();
+  }
+  return st;
+}
+
+// Replays one tuning in a fork of the post-setup() state and hands the stats
+// back over a pipe. False if the child failed.
+static bool forkReplay(const std::vector<RawBandsFrame>& set, const Tuning& tn, RunStats& st) {
+  std::string raw;
+  const int rc = forkRun([&](int fd) {
+    const RunStats r = replay(set, tn);
+    forkWrite(fd, &r, sizeof(r));
+    return 0;
+  }, &raw);
+  if (rc != 0 || raw.size() != sizeof(st)) return false;
+  memcpy((void*)&st, raw.data(), sizeof(st));
+  return true;
+}
+
+template <class T>
+static std::vector<T> parseList(char* arg, T (*conv)(const char*)) {
+  std::vector<T> v;
+  for (char* tok = strtok(arg, ","); tok; tok = strtok(nullptr, ",")) v.push_back(conv(tok));
+  return v;
+}
+static int   toInt(const char* s)   { return atoi(s); }
+static float toFloat(const char* s) { return (float)atof(s); }
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  bool csv = false, twice = false;
+  int palette = -1;
+  uint32_t seed = FX_SEED_HOST;
+  std::vector<int>   bass   = { settings.bassGate }, treble = { settings.trebleGate }, laser = { settings.laserGate };
+  std::vector<float> floorUp = { BandTuning().floorUp }, crestDecay = { BandTuning().crestDecay };
+
+  for (int i = 1; i < argc; i++) {
+    if      (!strcmp(argv[i], "--bass")        && i + 1 < argc) bass       = parseList(argv[++i], toInt);
+    else if (!strcmp(argv[i], "--treble")      && i + 1 < argc) treble     = parseList(argv[++i], toInt);
+    else if (!strcmp(argv[i], "--laser")       && i + 1 < argc) laser      = parseList(argv[++i], toInt);
+    else if (!strcmp(argv[i], "--floor-up")    && i + 1 < argc) floorUp    = parseList(argv[++i], toFloat);
+    else if (!strcmp(argv[i], "--crest-decay") && i + 1 < argc) crestDecay = parseList(argv[++i], toFloat);
+    else if (!strcmp(argv[i], "--palette")     && i + 1 < argc) palette    = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--seed")        && i + 1 < argc) seed       = (uint32_t)strtoul(argv[++i], nullptr, 0);
+    else if (!strcmp(argv[i], "--twice")) twice = true;
+    else if (!strcmp(argv[i], "--csv")) csv = true;
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else {
+      fprintf(stderr, "usage: %s [set.bin] [--bass L] [--treble L] [--laser L] [--floor-up L] [--crest-decay L] [--palette N] [--seed S] [--twice] [--csv]\n"
+                      "  L = comma-separated values; every combination is replayed\n", argv[0]);
+      return 2;
+    }
+  }
+  if (bass.empty() || treble.empty() || laser.empty() || floorUp.empty() || crestDecay.empty()) {
+    fprintf(stderr, "empty tuning list\n");
+    return 2;
+  }
+
+  std::vector<RawBandsFrame> set;
+  uint32_t lost = 0, bad = 0;
+  if (path) { if (!loadSet(path, set, lost, bad)) return 2; }
+  else syntheticSet(set);
+  if (set.size() < 2) { fprintf(stderr, "no raw band frames in %s\n", path); return 2; }
+
+  double secs = (uint32_t)(set.back().us - set.front().us) / 1e6;
+  printf("set: %s, %u frames over %.1f s (%.1f FPS), %u lost on the wire, %u skipped blocks (text/corrupt)\n",
+         path ? path : "synthetic", (unsigned)set.size(), secs, set.size() / max(secs, 1e-3),
+         (unsigned)lost, (unsigned)bad);
+
+  hostSetMicros(START_US);
+  g_chip.attach(STROBE_PIN, RESET_PIN, ANALOG_PIN);
+  setup();
+  currentMode = MUSIC_MODE;
+  if (palette >= 0) setMusicPalette((uint8_t)palette, 0, true);
+  seedEffects(seed);
+  if (!csv) printf("fx seed 0x%08lx\n", (unsigned long)seed);
+
+  if (csv) printf("bass,treble,laser,floor_up,crest_decay,frames,bass_hits,treble_hits,laser_triggers,evictions,frame_hash,mean_us,p99_us,max_us,speed_x\n");
+  else     printf("%5s %6s %5s %8s %8s | %6s %6s %6s %6s %5s %8s | %8s %8s %8s %7s\n", "bass", "treble", "laser",
+                  "floorUp", "crestDec", "frames", "bass", "treble", "laser", "evict", "hash", "mean_us", "p99_us", "max_us", "speed");
+  fflush(stdout);
+
+  int failed = 0;
+  for (int b : bass) for (int t : treble) for (int l : laser)
+  for (float fu : floorUp) for (float cd : crestDecay) {
+    Tuning tn = { b, t, l, fu, cd };
+    RunStats st, again;
+    if (!forkReplay(set, tn, st) || (twice && !forkReplay(set, tn, again))) { failed++; continue; }
+    const bool same = !twice || again.frameHash == st.frameHash;
+    if (!same) failed++;
+    if (csv) printf("%d,%d,%d,%g,%g,%u,%u,%u,%u,%u,%08lx,%.2f,%.2f,%.2f,%.0f\n", b, t, l, fu, cd,
+                    st.frames, st.bassHits, st.trebleHits, st.laserTriggers, st.evictions, (unsigned long)st.frameHash,
+                    st.mean, st.p99, st.max, st.speed);
+    else     printf("%5d %6d %5d %8g %8g | %6u %6u %6u %6u %5u %08lx | %8.2f %8.2f %8.2f %6.0fx%s\n", b, t, l, fu, cd,
+                    st.frames, st.bassHits, st.trebleHits, st.laserTriggers, st.evictions, (unsigned long)st.frameHash,
+                    st.mean, st.p99, st.max, st.speed, same ? "" : "  second run DIFFERS");
+    fflush(stdout);
+  }
+  return failed ? 1 : 0;
+}
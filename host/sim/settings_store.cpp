@@ -0,0 +1,212 @@
+// ============== Settings persistence vs a fake NVS ==============
+// Boots the firmware against a planted flash state (host/shim/Preferences.h)
+// and drives loop() on the virtual 60 FPS clock with scripted serial keys:
+//   fresh      : empty flash -> defaults, nothing written until a change
+//   debounce   : a nudge every frame for 1 s -> one write, SAVE_IDLE_MS later
+//   sweep      : nudges that never stop -> one write per SAVE_MAX_MS
+//   revert     : a change and its undo -> no write
+//   roundtrip  : every row stored non-default -> all loaded, none rewritten
+//   crc / truncated / magic / newer : damaged or foreign blob -> defaults
+//   old-build  : missing rows, an unknown key, an out-of-range value ->
+//                defaults / skipped / clamped, full blob on the next save
+//   write-fail : failed puts are retried after another idle period
+// Each case boots in its own forked process, so flash and firmware state
+// start clean every time.
+//
+//   pio run -e native_settings && .pio/build/native_settings/program
+
+#include "../../src/main.cpp"   // single TU: the harness reads main.cpp's statics
+#include "fork_run.h"
+
+#include <chrono>
+#include <vector>
+
+static const uint32_t FRAME_US = 16667;
+static const uint32_t START_US = 1000000;
+static const Settings DEFAULTS;
+
+static void runFrames(uint32_t n, const char* keyPerFrame = nullptr) {
+  for (uint32_t f = 0; f < n; f++) {
+    hostAdvanceMicros(FRAME_US);
+    if (keyPerFrame) Serial.rx = keyPerFrame;
+    loop();
+  }
+}
+static uint32_t framesFor(uint32_t ms) { return (uint32_t)((uint64_t)ms * 1000 / FRAME_US) + 1; }
+
+static std::vector<uint8_t> blobOf(const std::vector<SettingsRecord>& r) {
+  std::vector<uint8_t> b(sbSize((uint8_t)r.size()));
+  sbEncode(r.data(), (uint8_t)r.size(), b.data(), b.size());
+  return b;
+}
+static void plant(const std::vector<uint8_t>& b) { g_hostNvs.ns[NVS_NAMESPACE][NVS_KEY] = b; }
+
+// A value other than the default for every row
+static int otherValue(ParamId id) {
+  const ParamDef& p = PARAMS[id];
+  int d = paramGet(DEFAULTS, id);
+  return d == p.hi ? p.lo : (d + p.hi + 1) / 2;
+}
+static std::vector<SettingsRecord> allRows() {
+  std::vector<SettingsRecord> r;
+  for (uint8_t i = 0; i < P_COUNT; i++) r.push_back({ PARAMS[i].key, (int16_t)otherValue((ParamId)i) });
+  return r;
+}
+
+static bool atDefaults() {
+  for (uint8_t i = 0; i < P_COUNT; i++)
+    if (paramGet(settings, (ParamId)i) != paramGet(DEFAULTS, (ParamId)i)) return false;
+  return true;
+}
+
+// Flash holds a valid blob matching the edit copy
+static bool flashMatches() {
+  const std::vector<uint8_t>* b = g_hostNvs.find(NVS_NAMESPACE, NVS_KEY);
+  SettingsRecord r[SB_MAX_RECORDS];
+  uint8_t n = 0;
+  if (!b || sbDecode(b->data(), b->size(), r, SB_MAX_RECORDS, n) != SB_OK || n != P_COUNT) return false;
+  for (uint8_t i = 0; i < n; i++)
+    if (r[i].key != PARAMS[i].key || r[i].value != paramGet(settings, (ParamId)i)) return false;
+  return true;
+}
+
+struct Case { const char* name; bool (*run)(char* note, size_t n); };
+
+static bool caseFresh(char* note, size_t n) {
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "status=%s", SB_STATUS_NAMES[settingsLoadStatus]);
+  return settingsLoadStatus == SB_EMPTY && atDefaults() && g_hostNvs.writes == 0;
+}
+
+static bool caseDebounce(char* note, size_t n) {
+  const uint32_t typed = framesFor(1000);
+  runFrames(typed, "B");                               // bass gate +10 per frame, stays under 900
+  const uint32_t typing = g_hostNvs.writes;
+  runFrames(framesFor(SAVE_IDLE_MS) - 2);
+  const uint32_t early = g_hostNvs.writes;
+  runFrames(4);
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "writes while typing=%u, before idle=%u, total=%u, BassGate=%d",
+           (unsigned)typing, (unsigned)early, (unsigned)g_hostNvs.writes, settings.bassGate);
+  return typing == 0 && early == 0 && g_hostNvs.writes == 1 &&
+         settings.bassGate == DEFAULTS.bassGate + 10 * (int)typed && flashMatches();
+}
+
+static bool caseSweep(char* note, size_t n) {
+  const char* keys[] = { "B", "b" };
+  for (uint32_t s = 0; s < 150; s++) runFrames(60, keys[s & 1]);   // never idle for 150 s
+  const uint32_t during = g_hostNvs.writes;
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "writes during 150 s of edits=%u, after=%u (%u B)",
+           (unsigned)during, (unsigned)g_hostNvs.writes, (unsigned)g_hostNvs.bytesWritten);
+  return during == 150000 / SAVE_MAX_MS && g_hostNvs.writes == during + 1 && flashMatches();
+}
+
+static bool caseRevert(char* note, size_t n) {
+  Serial.rx = "B"; runFrames(1);
+  Serial.rx = "b"; runFrames(1);
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "writes=%u", (unsigned)g_hostNvs.writes);
+  return g_hostNvs.writes == 0;
+}
+
+static bool caseRoundtrip(char* note, size_t n) {
+  bool ok = settingsLoadStatus == SB_OK && settingsLoaded == P_COUNT;
+  for (uint8_t i = 0; i < P_COUNT; i++) ok &= paramGet(settings, (ParamId)i) == otherValue((ParamId)i);
+  ok &= palettesEqual(currentPal, musicPalettes[settings.palette]);   // no boot crossfade
+  ok &= frameSettings().brightness == settings.brightness;
+
+  auto t0 = std::chrono::steady_clock::now();
+  loadSettings();                                      // same blob again, timed on the host
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "loaded %u/%u, reload %.1f us (host), writes=%u",
+           (unsigned)settingsLoaded, (unsigned)P_COUNT, us, (unsigned)g_hostNvs.writes);
+  return ok && g_hostNvs.writes == 0;
+}
+
+static bool rejects(SbStatus want, char* note, size_t n) {
+  Serial.rx = "B"; runFrames(1);                       // the next save replaces the bad blob
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "status=%s, writes=%u", SB_STATUS_NAMES[settingsLoadStatus], (unsigned)g_hostNvs.writes);
+  return settingsLoadStatus == want && settings.bassGate == DEFAULTS.bassGate + 10 && g_hostNvs.writes == 1 && flashMatches();
+}
+
+static bool caseCrc(char* note, size_t n)       { bool ok = atDefaults(); return rejects(SB_CRC, note, n) && ok; }
+static bool caseTruncated(char* note, size_t n) { bool ok = atDefaults(); return rejects(SB_LENGTH, note, n) && ok; }
+static bool caseMagic(char* note, size_t n)     { bool ok = atDefaults(); return rejects(SB_MAGIC_BAD, note, n) && ok; }
+static bool caseNewer(char* note, size_t n)     { bool ok = atDefaults(); return rejects(SB_VERSION_BAD, note, n) && ok; }
+
+static bool caseOldBuild(char* note, size_t n) {
+  bool ok = settingsLoadStatus == SB_OK && settings.bassGate == 420 && settings.bounceLen == 250 &&
+            settings.laserAuto == DEFAULTS.laserAuto && settings.knobMode == DEFAULTS.knobMode;
+  Serial.rx = "B"; runFrames(1);
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "loaded %u, BounceLen=%d (clamped), writes=%u", (unsigned)settingsLoaded,
+           settings.bounceLen, (unsigned)g_hostNvs.writes);
+  return ok && settingsLoaded == 3 && g_hostNvs.writes == 1 && flashMatches();   // unknown key dropped, new rows added
+}
+
+static bool caseWriteFail(char* note, size_t n) {
+  g_hostNvs.failWrites = true;
+  Serial.rx = "B"; runFrames(1);
+  runFrames(framesFor(SAVE_IDLE_MS) + 2);
+  const uint32_t failed = g_hostNvs.failedWrites, fw = nvsWriteFails;
+  g_hostNvs.failWrites = false;
+  runFrames(framesFor(2 * SAVE_IDLE_MS));
+  snprintf(note, n, "failed=%u, then writes=%u", (unsigned)failed, (unsigned)g_hostNvs.writes);
+  return failed == 1 && fw == 1 && g_hostNvs.writes == 1 && flashMatches();
+}
+
+// Flash as the case boots with (planted before setup())
+static void bootState(const char* name) {
+  std::vector<uint8_t> b = blobOf(allRows());
+  if (!strcmp(name, "roundtrip") || !strcmp(name, "revert")) {
+    plant(b);
+  } else if (!strcmp(name, "crc")) {
+    b[6] ^= 0x40; plant(b);
+  } else if (!strcmp(name, "truncated")) {
+    b.pop_back(); plant(b);
+  } else if (!strcmp(name, "magic")) {
+    b[0] ^= 0xFF; plant(b);
+  } else if (!strcmp(name, "newer")) {
+    b[2] = SB_VERSION + 1;
+    uint16_t crc = crc16Ccitt(b.data(), b.size() - 2);
+    b[b.size() - 2] = (uint8_t)crc; b[b.size() - 1] = (uint8_t)(crc >> 8);
+    plant(b);
+  } else if (!strcmp(name, "old-build")) {
+    plant(blobOf({ { PARAMS[P_BASS_GATE].key, 420 }, { 200, 7 }, { PARAMS[P_BOUNCE_LEN].key, 999 },
+                   { PARAMS[P_MUSIC_GATE].key, 80 } }));
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) { fprintf(stderr, "usage: %s\n", argv[0]); return 2; }
+
+  const Case cases[] = {
+    { "fresh",      caseFresh },     { "debounce",  caseDebounce },  { "sweep",     caseSweep },
+    { "revert",     caseRevert },    { "roundtrip", caseRoundtrip }, { "crc",       caseCrc },
+    { "truncated",  caseTruncated }, { "magic",     caseMagic },     { "newer",     caseNewer },
+    { "old-build",  caseOldBuild },  { "write-fail", caseWriteFail },
+  };
+  printf("SAVE_IDLE_MS=%u SAVE_MAX_MS=%u, %u params, blob %u B\n", (unsigned)SAVE_IDLE_MS,
+         (unsigned)SAVE_MAX_MS, (unsigned)P_COUNT, (unsigned)sbSize(P_COUNT));
+  fflush(stdout);
+
+  int failed = 0;
+  for (const Case& c : cases) {
+    const int rc = forkRun([&](int) {
+      bootState(c.name);
+      hostSetMicros(START_US);
+      setup();
+      const uint32_t bootWrites = g_hostNvs.writes;
+      char note[160] = "";
+      bool ok = c.run(note, sizeof(note)) && bootWrites == 0;
+      printf("%-10s %s  %s\n", c.name, ok ? "PASS" : "FAIL", note);
+      return ok ? 0 : 1;
+    });
+    if (rc != 0) failed++;
+  }
+  printf("%d/%zu failed\n", failed, sizeof(cases) / sizeof(cases[0]));
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+// ============== MSGEQ7 acquisition simulation ==============
+// Runs Msgeq7Engine against the fake chip with the timer ISR firing on a
+// jittered 40 us schedule, and a 60 FPS loop() consuming the newest frame.
+// Each jitter runs with the ADC read inline in the tick and deferred, as on
+// the rig (adcTask converts right after the request, the tick collects it one
+// tick later). Reports frame rate, period jitter, settle margins and band
+// mix-ups, and
+// fails if any run with jitter up to MSGEQ7_JITTER_US breaks a chip timing
+// or reads a wrong band.
+//
+//   pio run -e native_msgeq7 && .pio/build/native_msgeq7/program [--jitter US] [--ms N]
+
+#include <Arduino.h>
+#include "fake_msgeq7.h"
+#include "msgeq7_engine.h"
+
+#include <vector>
+#include <algorithm>
+
+static const uint8_t SIM_STROBE = 12, SIM_RESET = 13, SIM_ADC = 36;
+
+struct SimIo {
+  static void     strobe(bool high) { digitalWrite(SIM_STROBE, high ? HIGH : LOW); }
+  static void     reset(bool high)  { digitalWrite(SIM_RESET,  high ? HIGH : LOW); }
+  static bool     sample(uint16_t& out) { out = analogRead(SIM_ADC); return true; }
+  static uint32_t nowUs()           { return micros(); }
+  static constexpr uint8_t WAIT_TICKS = 0;      // extra ticks per band spent on sample()
+};
+
+struct SimIoDeferred : SimIo {
+  static constexpr uint8_t WAIT_TICKS = 1;
+  static bool sample(uint16_t& out) {
+    static bool pending = false;
+    static uint16_t value = 0;
+    if (!pending) { value = analogRead(SIM_ADC); pending = true; return false; }
+    out = value;
+    pending = false;
+    return true;
+  }
+};
+
+struct SimResult {
+  uint32_t frames, consumed, mismatched;
+  double   fps, periodMeanUs, periodStdUs, periodMaxDevUs, latencyMeanUs, latencyMaxUs;
+  uint32_t minSettleUs, settleViolations, strobeViolations;
+};
+
+template <class Io>
+static SimResult simulate(uint32_t jitterUs, uint32_t durationMs) {
+  FakeMsgeq7 chip;
+  for (int b = 0; b < 7; b++) chip.level[b] = (uint16_t)(300 + b * 500);   // unique per band
+  chip.attach(SIM_STROBE, SIM_RESET, SIM_ADC);
+
+  Msgeq7Engine<Io> engine;
+  const uint64_t t0 = 1000000;
+  const uint64_t end = t0 + (uint64_t)durationMs * 1000;
+  const uint64_t loopPeriod = 16667;
+  uint64_t nextLoop = t0 + loopPeriod;
+  randomSeed(42);
+
+  std::vector<double> periods, latencies;
+  uint32_t lastFrameUs = 0, mismatched = 0, consumed = 0;
+  bool haveLast = false;
+
+  for (uint64_t k = 0;; k++) {
+    uint64_t nominal = t0 + k * MSGEQ7_TICK_US;
+    if (nominal >= end) break;
+
+    // loop() runs between ticks and consumes whatever is newest
+    while (nextLoop <= nominal) {
+      hostSetMicros(nextLoop);
+      Msgeq7Frame f;
+      if (engine.latest(f)) {
+        ++consumed;
+        latencies.push_back((double)max<int32_t>(0, (int32_t)(micros() - f.us)));   // a late tick can stamp after loop()
+        for (int b = 0; b < 7; b++) if (f.raw[b] != chip.level[b]) { ++mismatched; break; }
+      }
+      nextLoop += loopPeriod;
+    }
+
+    long j = jitterUs ? random(-(long)jitterUs, (long)jitterUs + 1) : 0;
+    hostSetMicros(nominal + j);
+    uint32_t before = engine.framesProduced();
+    engine.tick();
+    if (engine.framesProduced() != before) {
+      uint32_t now = micros();
+      if (haveLast) periods.push_back((double)(uint32_t)(now - lastFrameUs));
+      lastFrameUs = now;
+      haveLast = true;
+    }
+  }
+
+  SimResult r = {};
+  r.frames = engine.framesProduced();
+  r.consumed = consumed;
+  r.mismatched = mismatched;
+  r.fps = r.frames * 1000.0 / durationMs;
+
+  double nominalPeriod = (double)(engine.frameTicks() + MSGEQ7_BANDS * Io::WAIT_TICKS) * MSGEQ7_TICK_US;
+  double sum = 0, sq = 0, maxDev = 0;
+  for (double p : periods) { sum += p; maxDev = std::max(maxDev, fabs(p - nominalPeriod)); }
+  r.periodMeanUs = periods.empty() ? 0 : sum / periods.size();
+  for (double p : periods) sq += (p - r.periodMeanUs) * (p - r.periodMeanUs);
+  r.periodStdUs = periods.empty() ? 0 : sqrt(sq / periods.size());
+  r.periodMaxDevUs = maxDev;
+
+  double lsum = 0, lmax = 0;
+  for (double l : latencies) { lsum += l; lmax = std::max(lmax, l); }
+  r.latencyMeanUs = latencies.empty() ? 0 : lsum / latencies.size();
+  r.latencyMaxUs = lmax;
+
+  r.minSettleUs = chip.minSettleSeenUs;
+  r.settleViolations = chip.settleViolations;
+  r.strobeViolations = chip.strobeViolations;
+  return r;
+}
+
+int main(int argc, char** argv) {
+  std::vector<uint32_t> jitters = { 0, 1, 2, 4, MSGEQ7_JITTER_US, 12 };   // 12: past the budget, report only
+  uint32_t durationMs = 2000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--jitter") && i + 1 < argc) jitters = { (uint32_t)atoi(argv[++i]) };
+    else if (!strcmp(argv[i], "--ms") && i + 1 < argc) durationMs = (uint32_t)max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--jitter US] [--ms N]\n", argv[0]); return 2; }
+  }
+
+  printf("tick=%uus  nominal frame=%uus\n", (unsigned)MSGEQ7_TICK_US,
+         (unsigned)(Msgeq7Engine<SimIo>().frameTicks() * MSGEQ7_TICK_US));
+  printf("%8s %7s %8s %8s %9s %9s %9s %9s %9s %6s %6s %6s %6s\n",
+         "adc", "jit_us", "frames", "fps", "per_mean", "per_std", "per_dev", "lat_mean", "lat_max",
+         "settle", "s_vio", "st_vio", "bad");
+
+  bool clean = true;
+  for (int deferred = 0; deferred < 2; deferred++)
+  for (uint32_t j : jitters) {
+    SimResult r = deferred ? simulate<SimIoDeferred>(j, durationMs) : simulate<SimIo>(j, durationMs);
+    printf("%8s %7u %8u %8.1f %9.1f %9.2f %9.1f %9.1f %9.1f %6u %6u %6u %6u\n",
+           deferred ? "deferred" : "inline", (unsigned)j, (unsigned)r.frames, r.fps, r.periodMeanUs, r.periodStdUs, r.periodMaxDevUs,
+           r.latencyMeanUs, r.latencyMaxUs, (unsigned)r.minSettleUs,
+           (unsigned)r.settleViolations, (unsigned)r.strobeViolations, (unsigned)r.mismatched);
+    if (j <= MSGEQ7_JITTER_US && (r.mismatched || r.settleViolations || r.strobeViolations)) clean = false;
+  }
+  return clean ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+// ============== SlotPool eviction-order check ==============
+// Drives SlotPool with bursty spawns (drum-roll bursts well past capacity,
+// then quiet gaps with random expiries) and compares it step by step with a
+// plain std::deque model: live order must be spawn order, a full pool must
+// evict exactly the oldest, and release() must keep everyone else in order.
+//
+//   pio run -e native_segpool && .pio/build/native_segpool/program [--steps N]
+
+#include <Arduino.h>
+#include "slot_pool.h"
+
+#include <deque>
+#include <algorithm>
+
+static const uint8_t CAP = 64;
+
+struct Tag { uint32_t id; };
+
+static SlotPool<Tag, CAP> pool;
+static std::deque<uint32_t> model;   // live ids, oldest first
+static uint32_t failures = 0;
+
+static void fail(uint32_t step, const char* what) {
+  if (failures++ < 10) fprintf(stderr, "step %u: %s\n", (unsigned)step, what);
+}
+
+static void check(uint32_t step) {
+  if (pool.size() != model.size()) { fail(step, "size mismatch"); return; }
+  size_t k = 0;
+  for (uint8_t i = pool.first(); i != pool.NIL; i = pool.next(i), k++) {
+    if (k >= model.size()) { fail(step, "active list longer than size()"); return; }
+    if (pool[i].id != model[k]) { fail(step, "active list out of spawn order"); return; }
+  }
+  if (k != model.size()) fail(step, "active list shorter than size()");
+  if (!model.empty() && pool[pool.newest()].id != model.back()) fail(step, "newest() is not the last spawn");
+}
+
+int main(int argc, char** argv) {
+  uint32_t steps = 200000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--steps") && i + 1 < argc) steps = (uint32_t)max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--steps N]\n", argv[0]); return 2; }
+  }
+
+  randomSeed(7);
+  uint32_t nextId = 1, evicted = 0, released = 0;
+
+  for (uint32_t step = 0; step < steps; ) {
+    // burst: 1..3x capacity back to back, like a fast roll on both lanes
+    uint32_t burst = (uint32_t)random(1, CAP * 3);
+    for (uint32_t b = 0; b < burst && step < steps; b++, step++) {
+      bool wasFull = pool.full();
+      uint32_t oldest = model.empty() ? 0 : model.front();
+      uint8_t i = pool.spawn();
+      if (wasFull) {
+        // the recycled slot must be the one that held the oldest id
+        if (pool[i].id != oldest) fail(step, "evicted a slot that was not the oldest");
+        model.pop_front();
+        ++evicted;
+      }
+      pool[i].id = nextId;
+      model.push_back(nextId++);
+      check(step);
+    }
+
+    // gap: expire a few, mostly from the old end (same lifetime) but some random
+    uint32_t gap = (uint32_t)random(0, CAP);
+    for (uint32_t g = 0; g < gap && step < steps && pool.size(); g++, step++) {
+      uint8_t victim = pool.first();
+      long skip = random(0, 4) == 0 ? random(0, pool.size()) : 0;
+      while (skip-- > 0) victim = pool.next(victim);
+      uint32_t id = pool[victim].id;
+      pool.release(victim);
+      model.erase(std::find(model.begin(), model.end(), id));
+      ++released;
+      check(step);
+    }
+  }
+
+  if (pool.evictions() != evicted) fail(steps, "eviction counter mismatch");
+
+  printf("steps=%u spawned=%u evicted=%u released=%u live=%u failures=%u\n",
+         (unsigned)steps, (unsigned)(nextId - 1), (unsigned)evicted, (unsigned)released,
+         (unsigned)pool.size(), (unsigned)failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+// ============== FrameExchange stress test ==============
+// A render thread publishes frames whose every pixel encodes the frame
+// number; a show thread acquires and checks each presented frame is whole
+// (no pixel from another frame) and never older than the last one shown.
+//
+//   pio run -e native_frames && .pio/build/native_frames/program [--frames N]
+
+#include <FastLED.h>
+#include "frame_exchange.h"
+
+#include <thread>
+#include <atomic>
+
+static const int STRESS_LEDS = 600;
+struct StressFrame { uint32_t seq; CRGB s1[STRESS_LEDS]; CRGB s2[STRESS_LEDS]; };
+
+static inline CRGB stamp(uint32_t seq, int strip) {
+  return CRGB((uint8_t)seq, (uint8_t)(seq >> 8), (uint8_t)((seq >> 16) ^ strip));
+}
+
+int main(int argc, char** argv) {
+  uint32_t frames = 200000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = (uint32_t)max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--frames N]\n", argv[0]); return 2; }
+  }
+
+  static FrameExchange<StressFrame> ex;
+  std::atomic<bool> done{false};
+  uint32_t shown = 0, torn = 0, backwards = 0, lastSeq = 0;
+
+  std::thread show([&] {
+    for (;;) {
+      bool finished = done.load(std::memory_order_acquire);
+      if (!ex.acquire()) {
+        if (finished) break;
+        std::this_thread::yield();
+        continue;
+      }
+      const StressFrame& f = ex.front();
+      bool bad = false;
+      for (int i = 0; i < STRESS_LEDS && !bad; i++)
+        bad = f.s1[i] != stamp(f.seq, 1) || f.s2[i] != stamp(f.seq, 2);
+      if (bad) ++torn;
+      if (shown && f.seq <= lastSeq) ++backwards;
+      lastSeq = f.seq;
+      ++shown;
+    }
+  });
+
+  uint32_t rng = 12345;
+  for (uint32_t seq = 1; seq <= frames; seq++) {
+    StressFrame& b = ex.back();
+    b.seq = seq;
+    for (int i = 0; i < STRESS_LEDS; i++) { b.s1[i] = stamp(seq, 1); b.s2[i] = stamp(seq, 2); }
+    ex.publish();
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    if ((rng & 15) == 0) std::this_thread::yield();   // vary the interleaving
+  }
+  done.store(true, std::memory_order_release);
+  show.join();
+
+  printf("published=%u shown=%u dropped=%u torn=%u backwards=%u last=%u\n",
+         frames, shown, frames - shown, torn, backwards, lastSeq);
+  return (torn || backwards || lastSeq != frames) ? 1 : 0;
+}
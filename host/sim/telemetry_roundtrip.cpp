@@ -0,0 +1,169 @@
+// ============== Telemetry encoder/decoder round trip ==============
+// Encodes random TelemetryFrames, streams them through TxRing with a UART
+// that only takes a few bytes at a time, mixes in text lines (the firmware
+// still prints key feedback on the same port) and random corruption, then
+// decodes with TlmStreamDecoder. Every clean frame must come back identical
+// (text landing mid-frame may cost that one frame), every corrupted one must
+// be rejected, and nothing may decode twice.
+// Also pins the COBS encoder to a few reference vectors and checks the
+// 12-bit packing of the raw band capture packet.
+//
+//   pio run -e native_telemetry && .pio/build/native_telemetry/program [--frames N]
+
+#include <Arduino.h>
+#include "telemetry.h"
+
+#include <vector>
+
+static uint32_t failures = 0;
+static void fail(const char* what, uint32_t at) {
+  if (failures++ < 10) fprintf(stderr, "FAIL %s (frame %u)\n", what, (unsigned)at);
+}
+
+static bool sameFrame(const TelemetryFrame& a, const TelemetryFrame& b) {
+  if (a.seq != b.seq || a.ms != b.ms || a.peakN != b.peakN || a.sceneQ15 != b.sceneQ15 || a.quality != b.quality) return false;
+  for (int i = 0; i < 7; i++)
+    if (a.smooth[i] != b.smooth[i] || a.norm[i] != b.norm[i] || a.floorQ2[i] != b.floorQ2[i] || a.crestQ2[i] != b.crestQ2[i]) return false;
+  for (int i = 0; i < 4; i++) if (a.gates[i] != b.gates[i]) return false;
+  for (size_t i = 0; i < TLM_STAGES; i++) if (a.stageUs[i] != b.stageUs[i]) return false;
+  return true;
+}
+
+static TelemetryFrame randomFrame(uint16_t seq) {
+  TelemetryFrame f;
+  f.seq = seq;
+  f.ms  = (uint32_t)random(0, 0x7FFFFFFF);
+  // lots of zeros on purpose: they are what COBS has to escape
+  auto v16 = []() -> uint16_t { return random(0, 4) == 0 ? 0 : (uint16_t)random(0, 65536); };
+  for (int i = 0; i < 7; i++) {
+    f.smooth[i] = v16(); f.norm[i] = (uint8_t)random(0, 256);
+    f.floorQ2[i] = v16(); f.crestQ2[i] = v16();
+  }
+  f.peakN = (uint8_t)random(0, 256);
+  f.sceneQ15 = v16();
+  for (int i = 0; i < 4; i++) f.gates[i] = v16();
+  for (size_t i = 0; i < TLM_STAGES; i++) f.stageUs[i] = v16();
+  f.quality = (uint8_t)random(0, 5);
+  return f;
+}
+
+static void cobsVectors() {
+  struct V { std::vector<uint8_t> in, out; };
+  std::vector<uint8_t> ff(254, 0x11);                 // 254 non-zero bytes -> one full block
+  std::vector<uint8_t> ffOut = { 0xFF };
+  ffOut.insert(ffOut.end(), ff.begin(), ff.end());
+  ffOut.push_back(0x01);
+  const V vecs[] = {
+    { { 0x00 },                   { 0x01, 0x01 } },
+    { { 0x00, 0x00 },             { 0x01, 0x01, 0x01 } },
+    { { 0x11, 0x22, 0x00, 0x33 }, { 0x03, 0x11, 0x22, 0x02, 0x33 } },
+    { { 0x11, 0x22, 0x33, 0x44 }, { 0x05, 0x11, 0x22, 0x33, 0x44 } },
+    { ff,                         ffOut },
+  };
+  for (const V& v : vecs) {
+    std::vector<uint8_t> enc(v.in.size() + v.in.size() / 254 + 2), dec(v.in.size() + 2);
+    size_t n = cobsEncode(v.in.data(), v.in.size(), enc.data());
+    enc.resize(n);
+    if (enc != v.out) fail("cobs reference vector", 0);
+    size_t m = cobsDecode(enc.data(), enc.size(), dec.data());
+    dec.resize(m);
+    if (dec != v.in) fail("cobs reference decode", 0);
+  }
+  const uint8_t ascii[] = "123456789";
+  if (crc16Ccitt(ascii, 9) != 0x29B1) fail("crc16 check value", 0);
+}
+
+static void rawPacking() {
+  for (uint32_t k = 0; k < 5000; k++) {
+    RawBandsFrame r, d;
+    r.seq = (uint16_t)random(0, 65536);
+    r.us  = (uint32_t)random(0, 0x7FFFFFFF);
+    for (int i = 0; i < 7; i++) r.raw[i] = (uint16_t)(random(0, 3) == 0 ? (k & 1) * 4095 : random(0, 4096));
+    uint8_t payload[TLM_RAW_LEN + 4];
+    if (encodeRawBands(r, payload) != TLM_RAW_LEN) { fail("raw packet length", k); continue; }
+    if (!decodeRawBands(payload, TLM_RAW_LEN, d) || d.seq != r.seq || d.us != r.us) { fail("raw packet header", k); continue; }
+    for (int i = 0; i < 7; i++) if (d.raw[i] != r.raw[i]) { fail("raw 12-bit packing", k); break; }
+  }
+}
+
+int main(int argc, char** argv) {
+  uint32_t frames = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = (uint32_t)max(1, atoi(argv[++i]));
+    else { fprintf(stderr, "usage: %s [--frames N]\n", argv[0]); return 2; }
+  }
+
+  cobsVectors();
+  randomSeed(99);
+  rawPacking();
+
+  static TxRing<1024> tx;
+  TlmStreamDecoder rx;
+  std::vector<TelemetryFrame> sent;
+  std::vector<bool> corrupted;
+  uint32_t decoded = 0, corruptSent = 0, textLines = 0, midFrameText = 0;
+  uint8_t lastFed = 0;
+  size_t nextExpected = 0;
+
+  auto drain = [&](size_t budget) {
+    // UART stand-in: takes up to 'budget' bytes per pass
+    const uint8_t* p;
+    size_t n = tx.peek(p);
+    if (n > budget) n = budget;
+    for (size_t i = 0; i < n; i++) {
+      lastFed = p[i];
+      size_t len = rx.feed(p[i]);
+      if (!len) continue;
+      TelemetryFrame got;
+      if (!decodeTelemetry(rx.payload(), len, got)) { fail("verified payload did not parse", decoded); continue; }
+      // match by seq against what was queued; corrupted ones must never show up
+      while (nextExpected < sent.size() && sent[nextExpected].seq != got.seq) nextExpected++;
+      if (nextExpected >= sent.size()) { fail("decoded a frame that was never sent (or twice)", decoded); continue; }
+      if (corrupted[nextExpected]) fail("corrupted frame passed CRC", decoded);
+      else if (!sameFrame(got, sent[nextExpected])) fail("round trip mismatch", decoded);
+      nextExpected++;
+      decoded++;
+    }
+    tx.consume(n);
+  };
+
+  for (uint32_t f = 0; f < frames; f++) {
+    TelemetryFrame tf = randomFrame((uint16_t)f);
+    uint8_t payload[TLM_PAYLOAD_LEN], wire[TLM_WIRE_MAX];
+    size_t plen = encodeTelemetry(tf, payload);
+    if (plen != TLM_PAYLOAD_LEN) fail("payload length", f);
+    size_t n = frameTelemetry(payload, plen, wire);
+    if (n > TLM_WIRE_MAX) fail("wire length over TLM_WIRE_MAX", f);
+    for (size_t i = 1; i + 1 < n; i++) if (!wire[i]) fail("zero inside COBS body", f);
+
+    bool bad = random(0, 50) == 0;
+    if (bad) {
+      size_t at = 1 + (size_t)random(0, (long)(n - 2));
+      uint8_t flip = (uint8_t)(1u << random(0, 8));
+      if ((wire[at] ^ flip) == 0) flip ^= 0x03;   // keep the body zero-free: test the CRC, not framing
+      wire[at] ^= flip;
+      corruptSent++;
+    }
+    if (tx.push(wire, n)) { sent.push_back(tf); corrupted.push_back(bad); }
+
+    // interleaved key feedback text, written straight to the port
+    if (random(0, 30) == 0) {
+      const char* line = "Palette -> Party\n";
+      if (lastFed != 0) midFrameText++;            // costs the frame in flight, nothing else
+      for (const char* c = line; *c; c++) rx.feed((uint8_t)*c);
+      textLines++;
+    }
+    drain((size_t)random(16, 160));                 // FIFO room varies per pass
+  }
+  while (tx.used()) drain(128);
+
+  uint32_t clean = 0;
+  for (bool b : corrupted) clean += !b;
+  if (decoded > clean || decoded + midFrameText < clean) fail("clean frames lost", decoded);
+
+  printf("frames=%u queued=%u dropped_full=%u corrupted=%u text=%u (mid-frame %u) decoded=%u/%u rejected=%u failures=%u\n",
+         (unsigned)frames, (unsigned)sent.size(), (unsigned)tx.dropped(), (unsigned)corruptSent,
+         (unsigned)textLines, (unsigned)midFrameText, (unsigned)decoded, (unsigned)clean,
+         (unsigned)rx.bad(), (unsigned)failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,194 @@
+#pragma once
+// ============== Band analysis (envelope, adaptive floor, crest, normalize) ==============
+// Turns one 7-band MSGEQ7 frame into 0..255 loudness per band:
+//   fast  : EMA of the band level (attack EMA_FAST)
+//   floor : creeps up FLOOR_UP toward fast, drops FLOOR_DOWN when it's quieter
+//   crest : jumps to fast, decays CREST_DECAY toward floor
+//   norm  : compand((fast - floor - margin) / (crest - floor - margin))
+//
+// Two kernels over the same structure-of-arrays state:
+//   BandAnalyzerFloat - the original float math (sqrtf compand), kept as the
+//                       reference.
+//   BandAnalyzerQ15   - what the firmware runs. Levels are Q15 of ADC full
+//                       scale carried with 16 guard bits (Q31) so the slow
+//                       FLOOR_UP / CREST_DECAY steps don't round to zero;
+//                       coefficients are Q31 (0.002 in Q15 is 0.7% off and
+//                       the floor drifts visibly); the compand is a
+//                       threshold LUT. No float, no divide but one per band.
+// No GPIO or clock in here, so host/sim/band_kernels.cpp can replay traces
+// through both and compare.
+
+#include <stdint.h>
+#include <math.h>
+
+constexpr uint8_t BAND_COUNT = 7;
+
+// Tunables, in the historical 0..900 scale (ADC 0..4095 mapped). Runtime
+// values so host replays can sweep them; the defaults are what ships.
+struct BandTuning {
+  float emaFast        = 0.35f;   // fast envelope attack
+  float floorUp        = 0.002f;  // floor rises very slowly
+  float floorDown      = 0.20f;   // floor falls quickly when signal drops
+  float crestDecay     = 0.0025f; // per frame crest decay (slow)
+  float floorMargin900 = 20.0f;   // deadband above floor
+  float floorMax900    = 880.0f;
+  float crestGap900    = 10.0f;   // crest stays at least this far above floor
+  float minSpan900     = 5.0f;    // below this crest-floor span norm is 0
+  float compandGamma   = 0.5f;    // sqrt: punchier hits
+};
+
+// ---------------- float reference ----------------
+class BandAnalyzerFloat {
+public:
+  float fast[BAND_COUNT]  = {};
+  float floor[BAND_COUNT] = {};
+  float crest[BAND_COUNT] = {};
+  BandTuning tune;
+
+  void setTuning(const BandTuning& t) { tune = t; }
+
+  // raw: 12-bit ADC per band. Writes norm[], returns the max over bands.
+  uint8_t update(const uint16_t raw[BAND_COUNT], uint8_t norm[BAND_COUNT]) {
+    const BandTuning& T = tune;
+    uint8_t peak = 0;
+    for (uint8_t i = 0; i < BAND_COUNT; i++) {
+      float val900 = (float)((int32_t)raw[i] * 900 / 4095);   // same as map(raw, 0, 4095, 0, 900)
+
+      fast[i] += T.emaFast * (val900 - fast[i]);
+
+      if (fast[i] > floor[i]) floor[i] += T.floorUp   * (fast[i] - floor[i]);
+      else                    floor[i] += T.floorDown * (fast[i] - floor[i]);
+      if (floor[i] < 0)                floor[i] = 0;
+      if (floor[i] > T.floorMax900) floor[i] = T.floorMax900;
+
+      if (fast[i] > crest[i]) crest[i] = fast[i];
+      else                    crest[i] -= T.crestDecay * (crest[i] - floor[i]);
+      if (crest[i] < floor[i] + T.crestGap900) crest[i] = floor[i] + T.crestGap900;
+
+      float f = fast[i]  - (floor[i] + T.floorMargin900);
+      float d = crest[i] - (floor[i] + T.floorMargin900);
+      uint8_t n = 0;
+      if (d > T.minSpan900 && f > 0.0f) {
+        float x = T.compandGamma == 0.5f ? sqrtf(f / d) : powf(f / d, T.compandGamma);
+        if (x > 1.0f) x = 1.0f;
+        n = (uint8_t)(x * 255.0f + 0.5f);
+      }
+      norm[i] = n;
+      if (n > peak) peak = n;
+    }
+    return peak;
+  }
+
+  float fast900(uint8_t i)  const { return fast[i]; }
+  float floor900(uint8_t i) const { return floor[i]; }
+  float crest900(uint8_t i) const { return crest[i]; }
+};
+
+// ---------------- companding LUT ----------------
+// norm = round(255 * r^gamma) is monotonic in r, so instead of evaluating the
+// curve we store where each output step begins (t[n] = first Q16 ratio that
+// rounds to n) and binary-search: 8 compares, exact up to the Q16 ratio.
+class CompandLut {
+public:
+  explicit CompandLut(float gamma = 0.5f) { build(gamma); }
+
+  void build(float gamma) {
+    t_[0] = 0;
+    for (uint16_t n = 1; n < 256; n++) {
+      float r = powf((n - 0.5f) / 255.0f, 1.0f / gamma);   // inverse of the curve
+      uint32_t q = (uint32_t)ceilf(r * 65536.0f);
+      t_[n] = q > 0xFFFF ? 0xFFFF : (uint16_t)q;
+    }
+  }
+
+  // rQ16: ratio in Q16 (65536 = 1.0); anything above 1.0 saturates to 255.
+  uint8_t apply(uint32_t rQ16) const {
+    if (rQ16 > 0xFFFF) return 255;
+    uint8_t n = 0;
+    for (uint8_t step = 128; step; step >>= 1)
+      if (t_[n + step] <= rQ16) n += step;
+    return n;
+  }
+
+private:
+  uint16_t t_[256];
+};
+
+// ---------------- Q15 kernel ----------------
+constexpr int32_t bandCoef(double x)  { return x <= 0 ? 0 : x >= 1 ? INT32_MAX : (int32_t)(x * 2147483648.0 + 0.5); }   // Q31
+constexpr int32_t bandQ31(float v900) { return (int32_t)(v900 * (32767.0f / 900.0f) * 65536.0f + 0.5f); }
+
+class BandAnalyzerQ15 {
+public:
+  // Q31 levels (Q15 of ADC full scale << 16).
+  int32_t fast[BAND_COUNT]  = {};
+  int32_t floor[BAND_COUNT] = {};
+  int32_t crest[BAND_COUNT] = {};
+
+  BandAnalyzerQ15() { setTuning(BandTuning()); }
+
+  // Converts the tuning once; update() only sees integers.
+  void setTuning(const BandTuning& t) {
+    tune_ = t;
+    emaFast_    = bandCoef(t.emaFast);
+    floorUp_    = bandCoef(t.floorUp);
+    floorDown_  = bandCoef(t.floorDown);
+    crestDecay_ = bandCoef(t.crestDecay);
+    floorMax_   = bandQ31(t.floorMax900);
+    crestGap_   = bandQ31(t.crestGap900);
+    margin_     = bandQ31(t.floorMargin900);
+    minSpan_    = bandQ31(t.minSpan900);
+    // keep floor + margin/gap inside int32 and the ratio divisor non-zero
+    int32_t headroom = bandQ31(900.0f) - (margin_ > crestGap_ ? margin_ : crestGap_);
+    if (floorMax_ > headroom) floorMax_ = headroom;
+    if (minSpan_ < (1 << 16)) minSpan_ = 1 << 16;
+    compand_.build(t.compandGamma);
+  }
+  const BandTuning& tuning() const { return tune_; }
+
+  uint8_t update(const uint16_t raw[BAND_COUNT], uint8_t norm[BAND_COUNT]) {
+    uint8_t peak = 0;
+    for (uint8_t i = 0; i < BAND_COUNT; i++) {
+      int32_t in = ((int32_t)raw[i] * 900 / 4095) * IN_STEP_;      // same 0..900 steps as the reference
+
+      fast[i] += step(in - fast[i], emaFast_);
+
+      int32_t df = fast[i] - floor[i];
+      floor[i] += step(df, df > 0 ? floorUp_ : floorDown_);
+      if (floor[i] < 0)         floor[i] = 0;
+      if (floor[i] > floorMax_) floor[i] = floorMax_;
+
+      if (fast[i] > crest[i]) crest[i] = fast[i];
+      else                    crest[i] -= step(crest[i] - floor[i], crestDecay_);
+      if (crest[i] < floor[i] + crestGap_) crest[i] = floor[i] + crestGap_;
+
+      // Q31 / Q15 = Q16 ratio; d > minSpan_ keeps the Q15 divisor above 0.
+      int32_t f = fast[i]  - (floor[i] + margin_);
+      int32_t d = crest[i] - (floor[i] + margin_);
+      uint8_t n = 0;
+      if (d > minSpan_ && f > 0) n = compand_.apply((uint32_t)f / ((uint32_t)d >> 16));
+      norm[i] = n;
+      if (n > peak) peak = n;
+    }
+    return peak;
+  }
+
+  float fast900(uint8_t i)  const { return to900(fast[i]); }
+  float floor900(uint8_t i) const { return to900(floor[i]); }
+  float crest900(uint8_t i) const { return to900(crest[i]); }
+
+private:
+  static float to900(int32_t v) { return v * (900.0f / 32767.0f / 65536.0f); }
+
+  // x * coef (both Q31), rounded
+  static int32_t step(int32_t x, int32_t coef) {
+    return (int32_t)(((int64_t)x * coef + (1LL << 30)) >> 31);
+  }
+
+  static constexpr int32_t IN_STEP_ = bandQ31(1.0f);
+
+  BandTuning tune_;
+  int32_t emaFast_, floorUp_, floorDown_, crestDecay_;   // Q31 coefficients
+  int32_t floorMax_, crestGap_, margin_, minSpan_;        // Q31 levels
+  CompandLut compand_;
+};
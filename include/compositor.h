@@ -0,0 +1,125 @@
+#pragma once
+// ============== Layer compositor ==============
+// A frame is the base effect plus up to MAX_LAYERS layers, bottom to top,
+// each a blend mode, an opacity and one color per strip. apply() writes the
+// whole stack in at most one pass over a strip:
+//   - an opaque layer (BM_OVER at 255, BM_FADE at 255) hides everything
+//     below it, base included: coversBase() tells the caller to skip the
+//     base render, and the layers from there up fold into one color, so
+//     the pass is a plain fill
+//   - otherwise every layer is applied per pixel inside the same loop, in
+//     order, so the result is bit-identical to one pass per layer; one and
+//     two layers (flash, dim, flash+dim) get loops with the modes fixed at
+//     compile time, deeper stacks dispatch per pixel
+// Layers that can't change a pixel (opacity 0 over/fade, 255 dim) are
+// dropped when added. passes() counts strip passes, for the bench.
+
+#include <stdint.h>
+#include <FastLED.h>
+
+enum BlendMode : uint8_t {
+  BM_OVER,   // nblend(px, color, opacity): 255 replaces
+  BM_DIM,    // px.nscale8_video(opacity): never takes a lit channel to 0
+  BM_FADE,   // px.fadeToBlackBy(opacity): 255 is black
+};
+
+struct Layer {
+  BlendMode mode;
+  uint8_t   opacity;
+  CRGB      color[2];   // per strip (BM_OVER only)
+};
+
+class Compositor {
+public:
+  static constexpr uint8_t MAX_LAYERS = 6;
+
+  void clear() { n_ = 0; top_ = 0; }
+
+  void add(BlendMode mode, uint8_t opacity, const CRGB& c1 = CRGB::Black, const CRGB& c2 = CRGB::Black) {
+    if (n_ == MAX_LAYERS || noop(mode, opacity)) return;
+    layers_[n_] = { mode, opacity, { c1, c2 } };
+    if (opaque(layers_[n_])) top_ = n_ + 1;       // base and layers below are hidden
+    n_++;
+  }
+
+  bool    coversBase() const { return top_ > 0; }
+  uint8_t count()      const { return n_; }
+  const Layer& layer(uint8_t i) const { return layers_[i]; }
+  uint32_t passes()    const { return passes_; }
+
+  // Composite the stack onto strip s (0/1) in place.
+  void apply(CRGB* px, uint16_t n, uint8_t s) {
+    if (!n_) return;
+    passes_++;
+    if (top_) {                                   // opaque: one color for the whole strip
+      CRGB c = opaqueColor(layers_[top_ - 1], s);
+      for (uint8_t i = top_; i < n_; i++) blend(c, layers_[i], s);
+      fill_solid(px, n, c);
+      return;
+    }
+    if (n_ == 1) {                                // no per-pixel dispatch
+      switch (layers_[0].mode) {
+        case BM_OVER: run1<BM_OVER>(px, n, s); break;
+        case BM_DIM:  run1<BM_DIM>(px, n, s);  break;
+        case BM_FADE: run1<BM_FADE>(px, n, s); break;
+      }
+      return;
+    }
+    if (n_ == 2) {
+      switch (layers_[0].mode) {
+        case BM_OVER: run2<BM_OVER>(px, n, s); break;
+        case BM_DIM:  run2<BM_DIM>(px, n, s);  break;
+        case BM_FADE: run2<BM_FADE>(px, n, s); break;
+      }
+      return;
+    }
+    for (uint16_t p = 0; p < n; p++)
+      for (uint8_t i = 0; i < n_; i++) blend(px[p], layers_[i], s);
+  }
+
+  static void blend(CRGB& c, const Layer& l, uint8_t s) {
+    switch (l.mode) {
+      case BM_OVER: blendAs<BM_OVER>(c, l, s); break;
+      case BM_DIM:  blendAs<BM_DIM>(c, l, s);  break;
+      case BM_FADE: blendAs<BM_FADE>(c, l, s); break;
+    }
+  }
+
+private:
+  template <BlendMode M>
+  static void blendAs(CRGB& c, const Layer& l, uint8_t s) {
+    if (M == BM_OVER)     nblend(c, l.color[s], l.opacity);
+    else if (M == BM_DIM) c.nscale8_video(l.opacity);
+    else                  c.fadeToBlackBy(l.opacity);
+  }
+
+  template <BlendMode M>
+  void run1(CRGB* px, uint16_t n, uint8_t s) const {
+    const Layer l = layers_[0];
+    for (uint16_t p = 0; p < n; p++) blendAs<M>(px[p], l, s);
+  }
+
+  template <BlendMode M0, BlendMode M1>
+  void run2(CRGB* px, uint16_t n, uint8_t s) const {
+    const Layer l0 = layers_[0], l1 = layers_[1];
+    for (uint16_t p = 0; p < n; p++) { blendAs<M0>(px[p], l0, s); blendAs<M1>(px[p], l1, s); }
+  }
+
+  template <BlendMode M0>
+  void run2(CRGB* px, uint16_t n, uint8_t s) const {
+    switch (layers_[1].mode) {
+      case BM_OVER: run2<M0, BM_OVER>(px, n, s); break;
+      case BM_DIM:  run2<M0, BM_DIM>(px, n, s);  break;
+      case BM_FADE: run2<M0, BM_FADE>(px, n, s); break;
+    }
+  }
+
+  static bool noop(BlendMode m, uint8_t a) { return m == BM_DIM ? a == 255 : a == 0; }
+  static bool opaque(const Layer& l) { return l.opacity == 255 && l.mode != BM_DIM; }
+  static CRGB opaqueColor(const Layer& l, uint8_t s) { return l.mode == BM_OVER ? l.color[s] : CRGB(CRGB::Black); }
+
+  Layer    layers_[MAX_LAYERS];
+  uint8_t  n_ = 0;
+  uint8_t  top_ = 0;        // 1 + index of the topmost opaque layer, 0 if none
+  uint32_t passes_ = 0;
+};
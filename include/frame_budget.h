@@ -0,0 +1,112 @@
+#pragma once
+// ============== Frame budget: per-stage timing + adaptive quality ==============
+// loop() brackets each stage with mark(); end() folds the frame's render work
+// (everything but the show hand-off, which is paced by the LED wire, not by
+// quality) into a smoothed cost and steps a quality level:
+//   - smoothed work above HIGH% of the frame period for DEGRADE_FRAMES -> level+1
+//   - below LOW% for RECOVER_FRAMES                                     -> level-1
+// Recovery is deliberately slower than degrading so the level doesn't flap.
+// Level 0 is full quality; what each level means is up to the caller.
+//
+// Pure integer logic with the clock passed in, so the host can replay
+// captured stage timings through the same controller.
+
+#include <stdint.h>
+
+enum FrameStage : uint8_t {
+  FS_INPUT, FS_UI, FS_AUDIO, FS_EFFECT, FS_OVERLAY,
+  FS_DIM,      // now composited with the overlays (0); kept so trace columns line up
+  FS_SHOW, FS_COUNT
+};
+
+static const char* const FRAME_STAGE_NAMES[FS_COUNT] = {
+  "input", "ui", "audio", "effect", "overlay", "dim", "show"
+};
+
+class FrameBudget {
+public:
+  static constexpr uint8_t  HIGH_PCT       = 90;
+  static constexpr uint8_t  LOW_PCT        = 60;
+  static constexpr uint16_t DEGRADE_FRAMES = 8;
+  static constexpr uint16_t RECOVER_FRAMES = 120;
+  static constexpr uint8_t  EMA_SHIFT      = 3;     // 1/8 per frame
+
+  explicit FrameBudget(uint8_t targetFps = 60, uint8_t maxLevel = 4) : maxLevel_(maxLevel) {
+    setTargetFps(targetFps);
+  }
+
+  void setTargetFps(uint8_t fps) {
+    fps_ = fps ? fps : 1;
+    periodUs_ = 1000000UL / fps_;
+  }
+  uint8_t  targetFps() const { return fps_; }
+  uint32_t periodUs()  const { return periodUs_; }
+
+  // Frame pacing: true once per period. Falls back to "now" after a stall
+  // instead of bursting to catch up.
+  bool due(uint32_t nowUs) {
+    if (!started_ || (int32_t)(nextUs_ - nowUs) > (int32_t)periodUs_) {   // first call / clock stepped back
+      started_ = true;
+      nextUs_ = nowUs;
+    }
+    if ((int32_t)(nowUs - nextUs_) < 0) return false;
+    nextUs_ += periodUs_;
+    if ((int32_t)(nowUs - nextUs_) >= 0) nextUs_ = nowUs + periodUs_;
+    return true;
+  }
+
+  void begin(uint32_t nowUs) {
+    for (uint8_t i = 0; i < FS_COUNT; i++) stageUs_[i] = 0;
+    last_ = nowUs;
+  }
+
+  // Charge the time since the previous mark (or begin) to stage s.
+  void mark(FrameStage s, uint32_t nowUs) {
+    stageUs_[s] += nowUs - last_;
+    last_ = nowUs;
+  }
+
+  // Feed a whole frame of stage timings at once (host replay).
+  void feed(const uint32_t us[FS_COUNT]) {
+    for (uint8_t i = 0; i < FS_COUNT; i++) stageUs_[i] = us[i];
+  }
+
+  // Close the frame. Returns +1 / -1 when the level moved, else 0.
+  int8_t end() {
+    uint32_t work = 0;
+    for (uint8_t i = 0; i < FS_COUNT; i++) if (i != FS_SHOW) work += stageUs_[i];
+    workUs_ = work;
+    ++frames_;
+    if (work > periodUs_) ++overruns_;
+
+    if (!emaUs_) emaUs_ = work;
+    else emaUs_ = (uint32_t)((int32_t)emaUs_ + (((int32_t)work - (int32_t)emaUs_) >> EMA_SHIFT));
+
+    const uint32_t hi = periodUs_ / 100 * HIGH_PCT;
+    const uint32_t lo = periodUs_ / 100 * LOW_PCT;
+    if (emaUs_ > hi)      { overFor_++;  underFor_ = 0; }
+    else if (emaUs_ < lo) { underFor_++; overFor_  = 0; }
+    else                  { overFor_ = underFor_ = 0; }
+
+    if (overFor_ >= DEGRADE_FRAMES && level_ < maxLevel_) { level_++; overFor_ = underFor_ = 0; return +1; }
+    if (underFor_ >= RECOVER_FRAMES && level_ > 0)        { level_--; overFor_ = underFor_ = 0; return -1; }
+    return 0;
+  }
+
+  uint8_t  level()    const { return level_; }
+  uint8_t  maxLevel() const { return maxLevel_; }
+  uint32_t stageUs(FrameStage s) const { return stageUs_[s]; }
+  uint32_t workUs()   const { return workUs_; }
+  uint32_t emaUs()    const { return emaUs_; }
+  uint32_t frames()   const { return frames_; }
+  uint32_t overruns() const { return overruns_; }
+
+private:
+  uint8_t  fps_ = 60, maxLevel_, level_ = 0;
+  uint32_t periodUs_ = 16666;
+  bool     started_ = false;
+  uint32_t nextUs_ = 0, last_ = 0;
+  uint32_t stageUs_[FS_COUNT] = {};
+  uint32_t workUs_ = 0, emaUs_ = 0, frames_ = 0, overruns_ = 0;
+  uint16_t overFor_ = 0, underFor_ = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+// ============== Frame clock ==============
+// loop() reads the time once per frame (tick) and every stage of that frame
+// takes "now" from here instead of calling millis()/micros() itself, so all
+// of a frame's effects, overlays and timers agree on one instant and a host
+// harness that sets the clock before loop() fully determines the frame.
+//
+// ms() is derived from the microsecond count, so one clock read per frame
+// serves both; it keeps matching millis() across micros()' 71-minute wrap.
+// Pure integer logic with the clock passed in.
+
+#include <stdint.h>
+
+class FrameClock {
+public:
+  // Start at (nowUs, nowMs), two readings of the same clock; the first
+  // tick's dt is measured from here.
+  void reset(uint32_t nowUs, uint32_t nowMs) {
+    uint32_t subMs = nowUs - nowMs * 1000u;    // both wrap mod 2^32
+    if (subMs >= 1000) subMs = 0;              // a tick fell between the reads
+    totalUs_ = (uint64_t)nowMs * 1000u + subMs;
+    us_ = nowUs; ms_ = nowMs;
+    dtUs_ = dtMs_ = 0;
+    frame_ = 0;
+  }
+
+  // Once per frame, before any stage reads the clock.
+  void tick(uint32_t nowUs) {
+    dtUs_ = nowUs - us_;
+    us_ = nowUs;
+    totalUs_ += dtUs_;
+    const uint32_t ms = (uint32_t)(totalUs_ / 1000u);
+    dtMs_ = ms - ms_;
+    ms_ = ms;
+    frame_++;
+  }
+
+  uint32_t us()    const { return us_; }      // as micros() at the tick
+  uint32_t ms()    const { return ms_; }      // as millis() at the tick
+  uint32_t dtUs()  const { return dtUs_; }    // since the previous tick (uncapped)
+  uint32_t dtMs()  const { return dtMs_; }    // whole-ms steps of ms()
+  uint32_t frame() const { return frame_; }   // ticks since reset
+
+private:
+  uint64_t totalUs_ = 0;
+  uint32_t us_ = 0, ms_ = 0;
+  uint32_t dtUs_ = 0, dtMs_ = 0;
+  uint32_t frame_ = 0;
+};
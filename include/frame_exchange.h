@@ -0,0 +1,44 @@
+#pragma once
+// ============== Lock-free frame hand-off (triple buffer) ==============
+// The render side fills back(), then publish() swaps it with the middle slot.
+// The show side calls acquire() to swap the middle slot into front() when a
+// newer frame is waiting. Neither side ever waits on the other, and a slot is
+// only ever touched by one side at a time, so a presented frame is never torn.
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename Frame>
+class FrameExchange {
+public:
+  // ---- render side ----
+  Frame& back() { return bufs_[back_]; }
+
+  void publish() {
+    uint8_t prev = middle_.exchange((uint8_t)(back_ | FRESH), std::memory_order_acq_rel);
+    back_ = prev & INDEX;
+  }
+
+  // A published frame has not been picked up yet.
+  bool pending() const { return (middle_.load(std::memory_order_acquire) & FRESH) != 0; }
+
+  // ---- show side ----
+  bool acquire() {
+    if (!pending()) return false;
+    uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = prev & INDEX;
+    return true;
+  }
+
+  const Frame& front() const { return bufs_[front_]; }
+  Frame&       front()       { return bufs_[front_]; }
+
+private:
+  static constexpr uint8_t INDEX = 0x03;
+  static constexpr uint8_t FRESH = 0x80;
+
+  Frame bufs_[3];
+  uint8_t back_  = 0;                   // owned by render side
+  uint8_t front_ = 2;                   // owned by show side
+  std::atomic<uint8_t> middle_{1};      // shared slot (+FRESH when unread)
+};
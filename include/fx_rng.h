@@ -0,0 +1,56 @@
+#pragma once
+// ============== Per-effect PRNG ==============
+// xorshift32: one 32-bit word of state, three shifts per draw, no multiply
+// in the step (a 64-bit PCG step is several instructions on the ESP32's
+// 32-bit core). Each effect owns one and seeds it explicitly, so a run is
+// reproducible from its seed and one effect drawing more or fewer numbers
+// never shifts another effect's sequence.
+//
+// Ranged draws take the high bits and scale by multiply-shift, like
+// FastLED's random8(lim)/random16(lim) (xorshift's low bits are its weakest).
+// fillIndices() is the batch form for spawning, one step per index.
+
+#include <stdint.h>
+
+class FxRng {
+public:
+  explicit FxRng(uint32_t seed = 1) { setSeed(seed); }
+
+  void setSeed(uint32_t seed) { s_ = seed ? seed : 0x9E3779B9u; }   // 0 is xorshift's fixed point
+  uint32_t state() const { return s_; }
+
+  uint32_t next() {
+    uint32_t x = s_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return s_ = x;
+  }
+
+  uint8_t  u8()                        { return (uint8_t)(next() >> 24); }
+  uint8_t  u8(uint8_t lim)             { return (uint8_t)((u8() * (uint16_t)lim) >> 8); }              // [0, lim)
+  uint8_t  u8(uint8_t lo, uint8_t lim) { return (uint8_t)(lo + u8((uint8_t)(lim - lo))); }             // [lo, lim)
+  uint16_t u16()                       { return (uint16_t)(next() >> 16); }
+  uint16_t u16(uint16_t lim)           { return (uint16_t)(((uint32_t)u16() * lim) >> 16); }           // [0, lim)
+  int32_t  range(int32_t lo, int32_t hi) {                                                             // [lo, hi)
+    return hi > lo ? lo + (int32_t)(((uint64_t)next() * (uint32_t)(hi - lo)) >> 32) : lo;
+  }
+
+  // n indices in [0, lim).
+  void fillIndices(uint16_t* out, uint16_t n, uint16_t lim) {
+    for (uint16_t i = 0; i < n; i++) out[i] = u16(lim);
+  }
+
+  // A well-spread seed for stream `id` of a run seeded with `seed`
+  // (murmur3's finalizer), so per-effect streams don't start correlated.
+  static uint32_t streamSeed(uint32_t seed, uint8_t id) {
+    uint32_t h = seed + 0x9E3779B9u * (uint32_t)(id + 1);
+    h ^= h >> 16; h *= 0x85EBCA6Bu;
+    h ^= h >> 13; h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+  }
+
+private:
+  uint32_t s_;
+};
@@ -0,0 +1,106 @@
+#pragma once
+// ============== MSGEQ7 background acquisition ==============
+// Timer-ticked state machine that walks RESET/STROBE through the 7 bands and
+// latches one ADC sample per band. Complete frames go into a lock-free ring,
+// so loop() never waits on the chip; it just takes the newest frame.
+//
+// Io supplies the pins, ADC and clock as static functions:
+//   static void     strobe(bool high);
+//   static void     reset(bool high);
+//   static bool     sample(uint16_t& out);   // false = not converted yet
+//   static uint32_t nowUs();
+// sample() may hand the conversion to whoever owns the ADC and answer false
+// until it's done; the engine then asks again on the next tick with STROBE
+// still low, which holds the band on the chip's output.
+//
+// Timings per datasheet, in ticks of MSGEQ7_TICK_US:
+//   reset pulse >= 100 ns, reset->strobe >= 72 us,
+//   output settle >= 36 us, strobe->strobe >= 72 us.
+// Every interval is one tick longer than the minimum needs, so each keeps
+// its minimum with the two ticks bounding it up to MSGEQ7_JITTER_US early
+// or late (host/sim/sim_msgeq7.cpp checks this).
+
+#include <stdint.h>
+#include "seq_ring.h"
+
+constexpr uint32_t MSGEQ7_TICK_US           = 40;  // timer period
+constexpr uint32_t MSGEQ7_JITTER_US         = 8;   // tick lateness/earliness the timings absorb
+constexpr uint8_t  MSGEQ7_RESET_TICKS       = 1;   // RESET high
+constexpr uint8_t  MSGEQ7_RESET_STROBE_TICKS = 3;  // RESET low -> first STROBE (120 us)
+constexpr uint8_t  MSGEQ7_SETTLE_TICKS      = 2;   // STROBE low -> sample (80 us)
+constexpr uint8_t  MSGEQ7_STROBE_HIGH_TICKS = 1;   // STROBE high between bands (strobe->strobe 120 us)
+constexpr uint8_t  MSGEQ7_GAP_TICKS_DEFAULT = 1;   // idle after a frame -> 25 ticks = 1 kHz
+constexpr uint8_t  MSGEQ7_BANDS             = 7;
+
+struct Msgeq7Frame {
+  uint32_t us;                    // when the last band was latched
+  uint32_t seq;                   // frame counter
+  uint16_t raw[MSGEQ7_BANDS];     // 12-bit ADC, band 0 = 63 Hz
+};
+
+template <class Io>
+class Msgeq7Engine {
+public:
+  explicit Msgeq7Engine(uint8_t gapTicks = MSGEQ7_GAP_TICKS_DEFAULT) : gapTicks_(gapTicks) {}
+
+  // One timer tick. Never blocks; ISR-safe if Io's functions are.
+  void tick() {
+    if (wait_) { --wait_; return; }
+
+    switch (phase_) {
+      case PH_RESET:
+        Io::strobe(true);
+        Io::reset(true);
+        hold(PH_RESET_RELEASE, MSGEQ7_RESET_TICKS);
+        break;
+
+      case PH_RESET_RELEASE:
+        Io::reset(false);
+        band_ = 0;
+        hold(PH_STROBE_LOW, MSGEQ7_RESET_STROBE_TICKS);
+        break;
+
+      case PH_STROBE_LOW:
+        Io::strobe(false);              // selects the band, output starts settling
+        hold(PH_SAMPLE, MSGEQ7_SETTLE_TICKS);
+        break;
+
+      case PH_SAMPLE:
+        if (!Io::sample(cur_.raw[band_])) break;   // retry next tick
+        Io::strobe(true);
+        if (++band_ < MSGEQ7_BANDS) {
+          hold(PH_STROBE_LOW, MSGEQ7_STROBE_HIGH_TICKS);
+        } else {
+          cur_.us  = Io::nowUs();
+          cur_.seq = seq_++;
+          frames_.push(cur_);
+          hold(PH_RESET, gapTicks_ ? gapTicks_ : 1);
+        }
+        break;
+    }
+  }
+
+  // Consumer side (loop): newest complete frame since the last call.
+  bool latest(Msgeq7Frame& out) { return frames_.latest(cursor_, out); }
+
+  uint32_t framesProduced() const { return frames_.head(); }
+  uint32_t frameTicks()     const {      // with sample() answering at once
+    return MSGEQ7_RESET_TICKS + MSGEQ7_RESET_STROBE_TICKS +
+           MSGEQ7_BANDS * MSGEQ7_SETTLE_TICKS + (MSGEQ7_BANDS - 1) * MSGEQ7_STROBE_HIGH_TICKS +
+           (gapTicks_ ? gapTicks_ : 1);
+  }
+
+private:
+  enum Phase : uint8_t { PH_RESET, PH_RESET_RELEASE, PH_STROBE_LOW, PH_SAMPLE };
+
+  void hold(Phase next, uint8_t ticks) { phase_ = next; wait_ = ticks - 1; }
+
+  Phase    phase_ = PH_RESET;
+  uint8_t  wait_  = 0;
+  uint8_t  band_ = 0;
+  uint8_t  gapTicks_;
+  uint32_t seq_ = 0;
+  uint32_t cursor_ = 0;            // consumer position
+  Msgeq7Frame cur_ = {};
+  SeqRing<Msgeq7Frame, 8> frames_;
+};
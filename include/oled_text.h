@@ -0,0 +1,70 @@
+#pragma once
+// ============== OLED text model (8 rows x 21 chars) ==============
+// The UI screens are plain size-1 text, so a screen is just its characters:
+// one row per SSD1306 page (8 px), 21 cells of 6 px across. OledText takes
+// the same print/println/setCursor calls the screens made on the display
+// (wrapping at the right edge and clipping below the last row like GFX
+// does), but only writes characters - no pixels, no I2C. oledDiff() tells
+// which pages changed between two screens, so only those go on the bus.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+constexpr uint8_t OLED_ROWS   = 8;
+constexpr uint8_t OLED_COLS   = 21;
+constexpr uint8_t OLED_CHAR_W = 6;
+constexpr uint8_t OLED_CHAR_H = 8;
+
+struct OledScreen {
+  char rows[OLED_ROWS][OLED_COLS + 1];   // space padded, NUL terminated
+
+  OledScreen() { clear(); }
+  void clear() {
+    for (uint8_t r = 0; r < OLED_ROWS; r++) {
+      memset(rows[r], ' ', OLED_COLS);
+      rows[r][OLED_COLS] = 0;
+    }
+  }
+};
+
+// Bit r set when row r (= page r) differs.
+inline uint8_t oledDiff(const OledScreen& a, const OledScreen& b) {
+  uint8_t mask = 0;
+  for (uint8_t r = 0; r < OLED_ROWS; r++)
+    if (memcmp(a.rows[r], b.rows[r], OLED_COLS)) mask |= (uint8_t)(1u << r);
+  return mask;
+}
+
+class OledText {
+public:
+  void clear() { s_.clear(); col_ = row_ = 0; }
+  void setCursor(int16_t x, int16_t y) {
+    col_ = (uint8_t)(x / OLED_CHAR_W);
+    row_ = (uint8_t)(y / OLED_CHAR_H);
+  }
+
+  size_t print(const char* t) { size_t n = 0; for (; *t; t++, n++) write(*t); return n; }
+  size_t print(char c)            { write(c); return 1; }
+  size_t print(long v)            { char b[12]; snprintf(b, sizeof(b), "%ld", v);  return print(b); }
+  size_t print(unsigned long v)   { char b[12]; snprintf(b, sizeof(b), "%lu", v);  return print(b); }
+  size_t print(int v)             { return print((long)v); }
+  size_t print(unsigned v)        { return print((unsigned long)v); }
+  size_t println()                { write('\n'); return 1; }
+  template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+
+  const OledScreen& screen() const { return s_; }
+
+private:
+  void newline() { col_ = 0; if (row_ < OLED_ROWS) row_++; }
+  void write(char c) {
+    if (c == '\n') { newline(); return; }
+    if (c == '\r') return;
+    if (col_ >= OLED_COLS) newline();             // GFX wraps before the cell that won't fit
+    if (row_ < OLED_ROWS) s_.rows[row_][col_] = c;
+    col_++;
+  }
+
+  OledScreen s_;
+  uint8_t col_ = 0, row_ = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+// ============== Overwriting ring with per-slot sequence locks ==============
+// One producer (ISR/task) that never waits, any number of readers. When the
+// readers fall behind the oldest entries are simply overwritten; a reader
+// that loses a race with the producer sees a changed sequence and retries.
+// T must be trivially copyable.
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint8_t N>
+class SeqRing {
+public:
+  // producer side
+  void push(const T& v) {
+    uint32_t h = head_.load(std::memory_order_relaxed);
+    Slot& s = slots_[h % N];
+    s.seq.store(2 * h + 1, std::memory_order_relaxed);   // odd = being written
+    std::atomic_thread_fence(std::memory_order_release);
+    s.val = v;
+    s.seq.store(2 * h + 2, std::memory_order_release);
+    head_.store(h + 1, std::memory_order_release);
+  }
+
+  // Number of entries ever pushed; entry i lives until i + N is pushed.
+  uint32_t head() const { return head_.load(std::memory_order_acquire); }
+
+  // Copy entry i. False if it is not written yet or already overwritten.
+  bool read(uint32_t i, T& out) const {
+    const Slot& s = slots_[i % N];
+    uint32_t before = s.seq.load(std::memory_order_acquire);
+    if (before != 2 * i + 2) return false;
+    out = s.val;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.seq.load(std::memory_order_relaxed) == before;
+  }
+
+  // Newest complete entry, if any was pushed after *cursor. Updates cursor.
+  bool latest(uint32_t& cursor, T& out) const {
+    for (;;) {
+      uint32_t h = head();
+      if (h == cursor) return false;
+      if (read(h - 1, out)) { cursor = h; return true; }
+    }
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> seq{0};
+    T val;
+  };
+  Slot slots_[N];
+  std::atomic<uint32_t> head_{0};
+};
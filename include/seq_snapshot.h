@@ -0,0 +1,34 @@
+#pragma once
+// ============== Double-buffered snapshot with a sequence counter ==============
+// One writer, any number of readers. publish() copies into the back half and
+// bumps the sequence, which makes it the front half; readers only ever look
+// at the front. A reader that picks up sequence s may keep using at(s) until
+// the writer publishes twice more, so with one publish per frame a renderer
+// that starts after the publish and finishes before the next frame never
+// sees a half-written value. current(s) checks afterwards that no publish
+// slipped in (e.g. from a worker on the other core).
+// T must be trivially copyable.
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T>
+class SeqSnapshot {
+public:
+  // ---- writer side ----
+  void publish(const T& v) {
+    uint32_t s = seq_.load(std::memory_order_relaxed);
+    bufs_[(s + 1) & 1] = v;
+    seq_.store(s + 1, std::memory_order_release);
+  }
+
+  // ---- reader side ----
+  uint32_t seq() const { return seq_.load(std::memory_order_acquire); }
+  const T& at(uint32_t s) const { return bufs_[s & 1]; }
+  const T& get() const { return at(seq()); }
+  bool current(uint32_t s) const { return seq() == s; }
+
+private:
+  T bufs_[2];
+  std::atomic<uint32_t> seq_{0};
+};
@@ -0,0 +1,68 @@
+#pragma once
+// ============== Persisted settings blob (one NVS value) ==============
+// All persisted tunables as one little-endian blob under one NVS key:
+//
+//   off   type              field
+//   0     u16               magic (SB_MAGIC)
+//   2     u8                layout version (SB_VERSION)
+//   3     u8                record count n
+//   4     {u8 key, i16 v}   x n
+//   4+3n  u16               crc16 (CCITT-FALSE, LE) over everything before it
+//
+// Records are keyed, not positional: a key this build doesn't know is
+// skipped and a tunable the blob doesn't carry keeps its default, so adding
+// or retiring a tunable needs no migration - keys are never reused. Values
+// are clamped by whoever applies them, so a range change is safe too.
+// SB_VERSION changes only if this layout does; a blob from another layout,
+// or one that fails any check, is rejected whole and the caller keeps its
+// defaults.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry.h"   // crc16Ccitt
+
+static const uint16_t SB_MAGIC       = 0x5356;   // "VS"
+static const uint8_t  SB_VERSION     = 1;
+static const uint8_t  SB_MAX_RECORDS = 64;       // room for blobs from newer builds
+
+struct SettingsRecord { uint8_t key; int16_t value; };
+
+enum SbStatus : uint8_t { SB_OK, SB_EMPTY, SB_LENGTH, SB_MAGIC_BAD, SB_CRC, SB_VERSION_BAD };
+static const char* const SB_STATUS_NAMES[] = { "ok", "empty", "bad length", "bad magic", "bad crc", "unknown version" };
+
+constexpr size_t sbSize(uint8_t n) { return 4 + 3 * (size_t)n + 2; }
+static const size_t SB_MAX_BYTES = sbSize(SB_MAX_RECORDS);
+
+// Bytes written, 0 if out can't hold them.
+static inline size_t sbEncode(const SettingsRecord* r, uint8_t n, uint8_t* out, size_t cap) {
+  const size_t len = sbSize(n);
+  if (cap < len) return 0;
+  out[0] = (uint8_t)SB_MAGIC; out[1] = (uint8_t)(SB_MAGIC >> 8);
+  out[2] = SB_VERSION;
+  out[3] = n;
+  uint8_t* p = out + 4;
+  for (uint8_t i = 0; i < n; i++) {
+    *p++ = r[i].key;
+    *p++ = (uint8_t)r[i].value;
+    *p++ = (uint8_t)((uint16_t)r[i].value >> 8);
+  }
+  uint16_t crc = crc16Ccitt(out, len - 2);
+  p[0] = (uint8_t)crc; p[1] = (uint8_t)(crc >> 8);
+  return len;
+}
+
+// Checks and unpacks a blob. Records past maxOut are dropped; n is the
+// number kept (0 unless SB_OK).
+static inline SbStatus sbDecode(const uint8_t* p, size_t len, SettingsRecord* out, uint8_t maxOut, uint8_t& n) {
+  n = 0;
+  if (len == 0) return SB_EMPTY;
+  if (len < sbSize(0) || len != sbSize(p[3])) return SB_LENGTH;
+  if ((uint16_t)(p[0] | p[1] << 8) != SB_MAGIC) return SB_MAGIC_BAD;
+  if ((uint16_t)(p[len - 2] | p[len - 1] << 8) != crc16Ccitt(p, len - 2)) return SB_CRC;
+  if (p[2] != SB_VERSION) return SB_VERSION_BAD;
+
+  const uint8_t* r = p + 4;
+  for (uint8_t i = 0; i < p[3] && n < maxOut; i++, r += 3)
+    out[n++] = { r[0], (int16_t)(uint16_t)(r[1] | r[2] << 8) };
+  return SB_OK;
+}
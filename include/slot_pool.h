@@ -0,0 +1,85 @@
+#pragma once
+// ============== Fixed slot pool with age-ordered active list ==============
+// N slots of T. Free slots sit on a singly linked free list; live slots sit
+// on a doubly linked list in spawn order (head = oldest, tail = newest).
+// spawn(), release() and evict-oldest are O(1); iteration only visits live
+// slots. No heap, no per-frame scans of dead slots.
+//
+//   for (uint8_t i = pool.first(); i != pool.NIL; ) {
+//     uint8_t nx = pool.next(i);      // grab before a possible release(i)
+//     ... pool[i] ...
+//     i = nx;
+//   }
+
+#include <stdint.h>
+
+template <typename T, uint8_t N>
+class SlotPool {
+  static_assert(N > 0 && N < 255, "SlotPool indices are uint8_t with 255 reserved");
+
+public:
+  static constexpr uint8_t NIL = 0xFF;
+
+  SlotPool() { clear(); }
+
+  void clear() {
+    for (uint8_t i = 0; i < N; i++) { next_[i] = (uint8_t)(i + 1 < N ? i + 1 : NIL); prev_[i] = NIL; }
+    free_ = 0;
+    head_ = tail_ = NIL;
+    count_ = 0;
+    evictions_ = 0;
+  }
+
+  // Take a slot (evicting the oldest live one when full) and append it as the
+  // newest. The returned slot keeps its old contents; the caller overwrites it.
+  uint8_t spawn() {
+    uint8_t i = free_;
+    if (i != NIL) {
+      free_ = next_[i];
+      ++count_;
+    } else {
+      i = head_;                 // full: recycle the oldest
+      unlink(i);
+      ++evictions_;
+    }
+    append(i);
+    return i;
+  }
+
+  void release(uint8_t i) {
+    unlink(i);
+    next_[i] = free_;
+    prev_[i] = NIL;
+    free_ = i;
+    --count_;
+  }
+
+  uint8_t first()          const { return head_; }
+  uint8_t newest()         const { return tail_; }
+  uint8_t next(uint8_t i)  const { return next_[i]; }
+  uint8_t size()           const { return count_; }
+  bool    full()           const { return free_ == NIL; }
+  uint32_t evictions()     const { return evictions_; }
+  static constexpr uint8_t capacity() { return N; }
+
+  T&       operator[](uint8_t i)       { return slots_[i]; }
+  const T& operator[](uint8_t i) const { return slots_[i]; }
+
+private:
+  void append(uint8_t i) {
+    prev_[i] = tail_;
+    next_[i] = NIL;
+    if (tail_ != NIL) next_[tail_] = i; else head_ = i;
+    tail_ = i;
+  }
+
+  void unlink(uint8_t i) {
+    if (prev_[i] != NIL) next_[prev_[i]] = next_[i]; else head_ = next_[i];
+    if (next_[i] != NIL) prev_[next_[i]] = prev_[i]; else tail_ = prev_[i];
+  }
+
+  T        slots_[N];
+  uint8_t  next_[N], prev_[N];   // next_ doubles as the free-list link
+  uint8_t  free_, head_, tail_, count_;
+  uint32_t evictions_;
+};
@@ -0,0 +1,49 @@
+#pragma once
+// ============== Lock-free single-producer / single-consumer queue ==============
+// Bounded FIFO of N entries (N a power of two; 16-bit free-running indices).
+// The producer only writes head_, the consumer only writes tail_, so neither
+// ever waits or locks; a full queue rejects the push and the producer decides what to do (keep the
+// input for later, or drop and count). push() is safe from an ISR or a task
+// on the other core as long as there is exactly one producer.
+// T must be trivially copyable.
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint16_t N>
+class SpscQueue {
+  static_assert(N >= 2 && N <= 32768 && (N & (N - 1)) == 0, "N must be a power of two <= 32768");
+
+public:
+  // ---- producer side ----
+  bool push(const T& v) {
+    uint16_t h = head_.load(std::memory_order_relaxed);
+    if ((uint16_t)(h - tail_.load(std::memory_order_acquire)) >= N) return false;
+    buf_[h & (N - 1)] = v;
+    head_.store((uint16_t)(h + 1), std::memory_order_release);
+    return true;
+  }
+
+  // Free entries; only grows while the producer isn't pushing.
+  uint16_t space() const {
+    return (uint16_t)(N - (uint16_t)(head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire)));
+  }
+
+  // ---- consumer side ----
+  bool pop(T& out) {
+    uint16_t t = tail_.load(std::memory_order_relaxed);
+    if (t == head_.load(std::memory_order_acquire)) return false;
+    out = buf_[t & (N - 1)];
+    tail_.store((uint16_t)(t + 1), std::memory_order_release);
+    return true;
+  }
+
+  uint16_t size() const {
+    return (uint16_t)(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+  }
+
+private:
+  T buf_[N];
+  std::atomic<uint16_t> head_{0};   // next slot to write (producer)
+  std::atomic<uint16_t> tail_{0};   // next slot to read (consumer)
+};
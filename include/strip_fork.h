@@ -0,0 +1,100 @@
+#pragma once
+// ============== Two-strip fork/join ==============
+// run(fn, ctx) calls fn(ctx, 1) on a worker pinned to the other core while
+// the caller runs fn(ctx, 0), and returns only once both are done - the
+// barrier before anything touches both strips. fn must only write its own
+// strip's state. Until begin() (or with setEnabled(false)) run() just calls
+// both halves in turn on the caller.
+//
+// The worker waits on its task notification and signals a binary semaphore
+// when done, so the caller's own notifications (showTask's handshake) are
+// left alone. The host build uses a std::thread with the same semantics so
+// the bench can time both modes.
+
+#include <stdint.h>
+#ifdef NATIVE_BUILD
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+class StripForkJoin {
+public:
+  typedef void (*Fn)(void* ctx, uint8_t strip);
+
+  void setEnabled(bool on) { enabled_ = on; }
+  bool forked() const { return started_ && enabled_; }
+
+  void run(Fn fn, void* ctx) {
+    if (!forked()) { fn(ctx, 0); fn(ctx, 1); return; }
+    fork(fn, ctx);
+    fn(ctx, 0);
+    join();
+  }
+
+#ifndef NATIVE_BUILD
+  // core: where strip 1 renders (the caller keeps strip 0)
+  void begin(uint8_t core, UBaseType_t prio) {
+    if (started_) return;
+    done_ = xSemaphoreCreateBinary();
+    started_ = done_ && xTaskCreatePinnedToCore(task, "strip1", 4096, this, prio, &worker_, core) == pdPASS;
+  }
+
+private:
+  void fork(Fn fn, void* ctx) { fn_ = fn; ctx_ = ctx; xTaskNotifyGive(worker_); }
+  void join() { xSemaphoreTake(done_, portMAX_DELAY); }
+
+  static void task(void* p) {
+    StripForkJoin* self = (StripForkJoin*)p;
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      self->fn_(self->ctx_, 1);
+      xSemaphoreGive(self->done_);
+    }
+  }
+
+  TaskHandle_t      worker_ = nullptr;
+  SemaphoreHandle_t done_   = nullptr;
+  Fn                fn_     = nullptr;
+  void*             ctx_    = nullptr;
+#else
+  void begin(uint8_t = 0, unsigned = 0) {
+    if (started_) return;
+    h_ = new Host();                 // never freed: the worker lives as long as the process
+    std::thread([h = h_] {
+      std::unique_lock<std::mutex> lk(h->m);
+      for (;;) {
+        h->cv.wait(lk, [h] { return h->busy; });
+        lk.unlock();
+        h->fn(h->ctx, 1);
+        lk.lock();
+        h->busy = false;
+        h->cv.notify_all();
+      }
+    }).detach();
+    started_ = true;
+  }
+
+private:
+  struct Host {
+    std::mutex m;
+    std::condition_variable cv;
+    bool busy = false;
+    Fn   fn   = nullptr;
+    void* ctx = nullptr;
+  };
+  void fork(Fn fn, void* ctx) {
+    { std::lock_guard<std::mutex> lk(h_->m); h_->fn = fn; h_->ctx = ctx; h_->busy = true; }
+    h_->cv.notify_all();
+  }
+  void join() {
+    std::unique_lock<std::mutex> lk(h_->m);
+    h_->cv.wait(lk, [this] { return !h_->busy; });
+  }
+
+  Host* h_ = nullptr;
+#endif
+
+  bool  started_ = false;
+  bool  enabled_ = true;
+};
@@ -0,0 +1,271 @@
+#pragma once
+// ============== Binary telemetry (COBS + CRC16 framing) ==============
+// One fixed-layout little-endian packet per frame:
+//
+//   payload | crc16 (CCITT-FALSE, LE) -> COBS -> 0x00 delimiter
+//
+// COBS keeps 0x00 out of the frame body, so a reader resyncs on the next
+// delimiter after dropped bytes or interleaved text; the CRC rejects
+// anything mangled. Frames are queued into TxRing and drained with whatever
+// the UART can take right now, so the render loop never waits on the wire.
+//
+// Packet v1 (83 bytes). plotter.py mirrors this layout as TLM_STRUCT.
+//   off  type         field
+//   0    u8           type (TLM_TYPE_FRAME)
+//   1    u8           version (TLM_VERSION)
+//   2    u16          seq
+//   4    u32          ms
+//   8    u16[7]       smoothBands (0..900)
+//   22   u8[7]        bandNorm
+//   29   u16[7]       bandFloor  (Q2, x4)
+//   43   u16[7]       bandCrest  (Q2, x4)
+//   57   u8           audioPeakN
+//   58   u16          g_sceneLevel (Q15)
+//   60   u16[4]       gates: music, bass, treble, laser
+//   68   u16[7]       stage us: input, ui, audio, effect, overlay, dim, show
+//   82   u8           quality level
+//
+// Raw band capture v1 (19 bytes), 'x' record mode, one per frame readMSGEQ7 consumes:
+//   0    u8           type (TLM_TYPE_RAW)
+//   1    u8           version (TLM_VERSION)
+//   2    u16          seq (own counter; gaps = frames lost on the wire)
+//   4    u32          us (loop time the frame was consumed)
+//   8    u8[11]       7 x 12-bit ADC, packed LE in pairs: b0 | b1 << 12, ...
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+static const uint8_t TLM_TYPE_FRAME  = 0x01;
+static const uint8_t TLM_TYPE_RAW    = 0x02;
+static const size_t  TLM_RAW_LEN     = 19;
+static const uint8_t TLM_VERSION     = 1;
+static const size_t  TLM_PAYLOAD_LEN = 83;
+static const size_t  TLM_STAGES      = 7;
+// payload + crc, worst-case COBS overhead, leading and trailing delimiter
+static const size_t  TLM_WIRE_MAX    = TLM_PAYLOAD_LEN + 2 + (TLM_PAYLOAD_LEN + 2) / 254 + 1 + 2;
+
+struct TelemetryFrame {
+  uint16_t seq;
+  uint32_t ms;
+  uint16_t smooth[7];
+  uint8_t  norm[7];
+  uint16_t floorQ2[7];
+  uint16_t crestQ2[7];
+  uint8_t  peakN;
+  uint16_t sceneQ15;
+  uint16_t gates[4];
+  uint16_t stageUs[TLM_STAGES];
+  uint8_t  quality;
+};
+
+// ---- CRC16/CCITT-FALSE (poly 0x1021, init 0xFFFF) ----
+static inline uint16_t crc16Ccitt(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF) {
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (uint8_t b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+// ---- COBS ----
+// out must hold n + n/254 + 1 bytes. Returns encoded length (no delimiter).
+static inline size_t cobsEncode(const uint8_t* in, size_t n, uint8_t* out) {
+  size_t w = 1, code = 0;
+  uint8_t run = 1;
+  for (size_t i = 0; i < n; i++) {
+    if (in[i]) { out[w++] = in[i]; run++; }
+    if (!in[i] || run == 0xFF) {
+      out[code] = run;
+      code = w++;
+      run = 1;
+    }
+  }
+  out[code] = run;
+  return w;
+}
+
+// Returns decoded length, or 0 on a malformed block (a zero inside or a code
+// that runs past the end).
+static inline size_t cobsDecode(const uint8_t* in, size_t n, uint8_t* out) {
+  size_t r = 0, w = 0;
+  while (r < n) {
+    uint8_t code = in[r++];
+    if (!code || r + code - 1 > n) return 0;
+    for (uint8_t i = 1; i < code; i++) {
+      if (!in[r]) return 0;
+      out[w++] = in[r++];
+    }
+    if (code != 0xFF && r < n) out[w++] = 0;
+  }
+  return w;
+}
+
+// ---- packet layout ----
+static inline uint8_t* tlmPut16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); return p + 2; }
+static inline uint8_t* tlmPut32(uint8_t* p, uint32_t v) { p = tlmPut16(p, (uint16_t)v); return tlmPut16(p, (uint16_t)(v >> 16)); }
+static inline uint16_t tlmGet16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t tlmGet32(const uint8_t* p) { return tlmGet16(p) | ((uint32_t)tlmGet16(p + 2) << 16); }
+
+static inline size_t encodeTelemetry(const TelemetryFrame& f, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TLM_TYPE_FRAME;
+  *p++ = TLM_VERSION;
+  p = tlmPut16(p, f.seq);
+  p = tlmPut32(p, f.ms);
+  for (int i = 0; i < 7; i++) p = tlmPut16(p, f.smooth[i]);
+  for (int i = 0; i < 7; i++) *p++ = f.norm[i];
+  for (int i = 0; i < 7; i++) p = tlmPut16(p, f.floorQ2[i]);
+  for (int i = 0; i < 7; i++) p = tlmPut16(p, f.crestQ2[i]);
+  *p++ = f.peakN;
+  p = tlmPut16(p, f.sceneQ15);
+  for (int i = 0; i < 4; i++) p = tlmPut16(p, f.gates[i]);
+  for (size_t i = 0; i < TLM_STAGES; i++) p = tlmPut16(p, f.stageUs[i]);
+  *p++ = f.quality;
+  return (size_t)(p - out);
+}
+
+static inline bool decodeTelemetry(const uint8_t* in, size_t n, TelemetryFrame& f) {
+  if (n != TLM_PAYLOAD_LEN || in[0] != TLM_TYPE_FRAME || in[1] != TLM_VERSION) return false;
+  const uint8_t* p = in + 2;
+  f.seq = tlmGet16(p); p += 2;
+  f.ms  = tlmGet32(p); p += 4;
+  for (int i = 0; i < 7; i++, p += 2) f.smooth[i] = tlmGet16(p);
+  for (int i = 0; i < 7; i++) f.norm[i] = *p++;
+  for (int i = 0; i < 7; i++, p += 2) f.floorQ2[i] = tlmGet16(p);
+  for (int i = 0; i < 7; i++, p += 2) f.crestQ2[i] = tlmGet16(p);
+  f.peakN = *p++;
+  f.sceneQ15 = tlmGet16(p); p += 2;
+  for (int i = 0; i < 4; i++, p += 2) f.gates[i] = tlmGet16(p);
+  for (size_t i = 0; i < TLM_STAGES; i++, p += 2) f.stageUs[i] = tlmGet16(p);
+  f.quality = *p++;
+  return true;
+}
+
+struct RawBandsFrame {
+  uint16_t seq;
+  uint32_t us;
+  uint16_t raw[7];   // 12-bit
+};
+
+static inline size_t encodeRawBands(const RawBandsFrame& f, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TLM_TYPE_RAW;
+  *p++ = TLM_VERSION;
+  p = tlmPut16(p, f.seq);
+  p = tlmPut32(p, f.us);
+  for (int i = 0; i < 7; i += 2) {
+    uint32_t v = (f.raw[i] & 0xFFF) | (i + 1 < 7 ? (uint32_t)(f.raw[i + 1] & 0xFFF) << 12 : 0);
+    *p++ = (uint8_t)v;
+    *p++ = (uint8_t)(v >> 8);
+    if (i + 1 < 7) *p++ = (uint8_t)(v >> 16);
+  }
+  return (size_t)(p - out);
+}
+
+static inline bool decodeRawBands(const uint8_t* in, size_t n, RawBandsFrame& f) {
+  if (n != TLM_RAW_LEN || in[0] != TLM_TYPE_RAW || in[1] != TLM_VERSION) return false;
+  const uint8_t* p = in + 2;
+  f.seq = tlmGet16(p); p += 2;
+  f.us  = tlmGet32(p); p += 4;
+  for (int i = 0; i < 7; i += 2) {
+    uint32_t v = p[0] | (p[1] << 8);
+    if (i + 1 < 7) v |= (uint32_t)p[2] << 16;
+    p += (i + 1 < 7) ? 3 : 2;
+    f.raw[i] = v & 0xFFF;
+    if (i + 1 < 7) f.raw[i + 1] = (v >> 12) & 0xFFF;
+  }
+  return true;
+}
+
+// payload -> 0x00 | COBS(payload | crc) | 0x00. out needs TLM_WIRE_MAX (enough
+// for any packet type). The leading delimiter ends whatever text came before.
+static inline size_t frameTelemetry(const uint8_t* payload, size_t n, uint8_t* out) {
+  uint8_t body[TLM_PAYLOAD_LEN + 2];
+  if (n > TLM_PAYLOAD_LEN) return 0;
+  memcpy(body, payload, n);
+  uint16_t crc = crc16Ccitt(payload, n);
+  body[n] = (uint8_t)crc;
+  body[n + 1] = (uint8_t)(crc >> 8);
+  out[0] = 0;
+  size_t len = 1 + cobsEncode(body, n + 2, out + 1);
+  out[len++] = 0;
+  return len;
+}
+
+// ---- streaming reader: feed bytes, get whole verified payloads ----
+class TlmStreamDecoder {
+public:
+  // Returns payload length when b completes a valid frame (payload in
+  // payload()), else 0. Bad frames are counted and skipped.
+  size_t feed(uint8_t b) {
+    if (b != 0) {
+      if (len_ < sizeof(buf_)) buf_[len_++] = b;
+      else overflow_ = true;
+      return 0;
+    }
+    size_t n = 0;
+    if (len_) {
+      if (overflow_) ++bad_;
+      else n = finish();
+    }
+    len_ = 0;
+    overflow_ = false;
+    return n;
+  }
+
+  const uint8_t* payload() const { return out_; }
+  uint32_t good() const { return good_; }
+  uint32_t bad()  const { return bad_; }
+
+private:
+  size_t finish() {
+    size_t n = cobsDecode(buf_, len_, out_);
+    if (n < 3) { ++bad_; return 0; }
+    uint16_t crc = (uint16_t)(out_[n - 2] | (out_[n - 1] << 8));
+    if (crc16Ccitt(out_, n - 2) != crc) { ++bad_; return 0; }
+    ++good_;
+    return n - 2;
+  }
+
+  uint8_t  buf_[TLM_WIRE_MAX];
+  uint8_t  out_[TLM_WIRE_MAX];
+  size_t   len_ = 0;
+  bool     overflow_ = false;
+  uint32_t good_ = 0, bad_ = 0;
+};
+
+// ---- non-blocking TX byte ring ----
+// push() takes a whole frame or nothing (a half-sent frame is just noise to
+// the reader); the caller drains contiguous chunks with peek()/consume().
+template <size_t N>
+class TxRing {
+  static_assert((N & (N - 1)) == 0, "TxRing size must be a power of two");
+
+public:
+  bool push(const uint8_t* p, size_t n) {
+    if (n > space()) { ++dropped_; return false; }
+    for (size_t i = 0; i < n; i++) buf_[(head_ + i) & (N - 1)] = p[i];
+    head_ += n;
+    return true;
+  }
+
+  size_t used() const { return head_ - tail_; }
+  size_t space() const { return N - used(); }
+
+  // Longest run readable without wrapping.
+  size_t peek(const uint8_t*& p) const {
+    size_t off = tail_ & (N - 1);
+    size_t run = N - off;
+    p = buf_ + off;
+    return used() < run ? used() : run;
+  }
+  void consume(size_t n) { tail_ += n; }
+
+  uint32_t dropped() const { return dropped_; }
+
+private:
+  uint8_t  buf_[N];
+  size_t   head_ = 0, tail_ = 0;
+  uint32_t dropped_ = 0;
+};
@@ -1,3 +1,6 @@
+import binascii
+import struct
+
 import serial
 from PyQt5 import QtWidgets, QtCore
 import pyqtgraph as pg
@@ -9,6 +12,13 @@ BAUD_RATE = 115200
 WINDOW_SIZE = 250
 PLOT_BANDS = list(range(7))  # Bands 0 through 6
 
+# === TELEMETRY FORMAT (mirror of include/telemetry.h, packet v1) ===
+# 0x00 | COBS(payload | crc16-ccitt-false LE) | 0x00, one packet per frame ('g' toggles)
+TLM_TYPE_FRAME = 0x01
+TLM_VERSION = 1
+TLM_STRUCT = struct.Struct('<BBHI7H7B7H7HBH4H7HB')   # 83 bytes
+STAGE_NAMES = ['input', 'ui', 'audio', 'effect', 'overlay', 'dim', 'show']
+
 # === COLOR GROUPING ===
 band_groups = {
     0: ('r', 'Bass'),
@@ -21,7 +31,47 @@ band_groups = {
 }
 
 # === SERIAL SETUP ===
-ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1)
+ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=0)   # non-blocking: read what's there
+
+
+def cobs_decode(block):
+    out = bytearray()
+    i = 0
+    while i < len(block):
+        code = block[i]
+        if code == 0 or i + code > len(block):
+            return None
+        out += block[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(block):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_packet(block):
+    """COBS block (between 0x00 delimiters) -> dict, or None if it isn't a good packet."""
+    raw = cobs_decode(block)
+    if raw is None or len(raw) != TLM_STRUCT.size + 2:
+        return None
+    payload, crc = raw[:-2], raw[-2] | (raw[-1] << 8)
+    if binascii.crc_hqx(payload, 0xFFFF) != crc:
+        return None
+    f = TLM_STRUCT.unpack(payload)
+    if f[0] != TLM_TYPE_FRAME or f[1] != TLM_VERSION:
+        return None
+    return {
+        'seq': f[2], 'ms': f[3],
+        'smooth': f[4:11], 'norm': f[11:18],
+        'floor': [v / 4 for v in f[18:25]], 'crest': [v / 4 for v in f[25:32]],
+        'peak': f[32], 'scene': f[33] / 32767,
+        'gates': dict(zip(('music', 'bass', 'treble', 'laser'), f[34:38])),
+        'stages': dict(zip(STAGE_NAMES, f[38:45])),
+        'quality': f[45],
+    }
+
+
+rx_buf = bytearray()
+stats = {'good': 0, 'bad': 0, 'lost': 0, 'last_seq': None}
 
 # === QT APP + LAYOUT ===
 app = QtWidgets.QApplication([])
@@ -83,36 +133,54 @@ plot.addItem(threshold_line_treble)
 
 # === UPDATE FUNCTION ===
 def update():
+    global rx_buf
     try:
-        line = ser.readline().decode('utf-8', errors='ignore').strip()
-        line = line.rstrip(",")
-        parts = line.split(",")
-
-        print("Parsed parts:", parts)
-
-        if len(parts) == 9 and all(p.replace('.', '', 1).isdigit() for p in parts):
-            values = [float(p) for p in parts]
-
+        rx_buf += ser.read(ser.in_waiting or 1)
+        *blocks, rx_buf = rx_buf.split(b'\x00')
+        latest = None
+        for block in blocks:
+            if not block:
+                continue
+            pkt = decode_packet(block)
+            if pkt is None:
+                stats['bad'] += 1
+                text = block.decode('utf-8', errors='ignore').strip()
+                if text.isprintable() and text:
+                    print(text)                      # key feedback printed by the firmware
+                continue
+            stats['good'] += 1
+            if stats['last_seq'] is not None:
+                stats['lost'] += (pkt['seq'] - stats['last_seq'] - 1) & 0xFFFF
+            stats['last_seq'] = pkt['seq']
+
+            # every packet goes into the history, the screen redraws once per tick
             for band in PLOT_BANDS:
                 data[band] = np.roll(data[band], -1)
-                data[band][-1] = values[band]
-
-                if checkboxes[band].isChecked():
-                    curves[band].setData(data[band])
-                else:
-                    curves[band].setData([])
-
-            # Update threshold lines and text labels
-            bass_thresh = max(0, min(values[7], 1023))
-            treble_thresh = max(0, min(values[8], 1023))
-
-            threshold_line_bass.setValue(bass_thresh)
-            threshold_line_treble.setValue(treble_thresh)
-            text_bass.setPos(0, bass_thresh)
-            text_treble.setPos(0, treble_thresh)
-
-        else:
-            print("Malformed line skipped:", line)
+                data[band][-1] = pkt['smooth'][band]
+            latest = pkt
+
+        if latest is None:
+            return
+
+        for band in PLOT_BANDS:
+            if checkboxes[band].isChecked():
+                curves[band].setData(data[band])
+            else:
+                curves[band].setData([])
+
+        # Update threshold lines and text labels
+        bass_thresh = max(0, min(latest['gates']['bass'], 1023))
+        treble_thresh = max(0, min(latest['gates']['treble'], 1023))
+
+        threshold_line_bass.setValue(bass_thresh)
+        threshold_line_treble.setValue(treble_thresh)
+        text_bass.setPos(0, bass_thresh)
+        text_treble.setPos(0, treble_thresh)
+
+        work = sum(v for k, v in latest['stages'].items() if k != 'show')
+        main_widget.setWindowTitle(
+            f"MSGEQ7 Visualizer  |  scene {latest['scene']:.2f}  q{latest['quality']}  "
+            f"work {work}us  |  packets {stats['good']} lost {stats['lost']} bad {stats['bad']}")
 
     except Exception as e:
         print("Plot update error:", e)
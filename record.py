@@ -0,0 +1,45 @@
+import sys
+import time
+
+import serial
+
+# === CONFIG ===
+SERIAL_PORT = '/dev/cu.usbserial-0001'
+BAUD_RATE = 115200
+
+# === USAGE ===
+#   python3 record.py set.bin        (Ctrl-C to stop)
+# Sends 'x' to start raw band capture, saves the byte stream as it arrives,
+# sends 'x' again on exit. The file is the wire format itself (COBS/CRC
+# packets, see include/telemetry.h); replay it with
+#   .pio/build/native_replay/program set.bin
+# Leave telemetry ('g') off while recording, or the file grows ~5x.
+
+if len(sys.argv) != 2:
+    print("usage: record.py OUTFILE")
+    sys.exit(2)
+
+ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=0.2)
+ser.reset_input_buffer()
+ser.write(b'x')
+
+total = 0
+start = time.time()
+last_status = 0.0
+with open(sys.argv[1], 'wb') as out:
+    try:
+        while True:
+            chunk = ser.read(ser.in_waiting or 1)
+            if chunk:
+                out.write(chunk)
+                total += len(chunk)
+            secs = time.time() - start
+            if secs - last_status >= 0.5:
+                last_status = secs
+                print(f"\r{secs:7.1f} s  {total / 1024:8.1f} KB  (~{total / 24 / max(secs, 0.1):5.1f} frames/s)", end='')
+    except KeyboardInterrupt:
+        pass
+    finally:
+        ser.write(b'x')
+        out.write(ser.read(ser.in_waiting))
+print()
@@ -3,6 +3,24 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <Wire.h>
+#include <Preferences.h>
+#include "msgeq7_engine.h"
+#include "frame_exchange.h"
+#include "slot_pool.h"
+#include "frame_budget.h"
+#include "telemetry.h"
+#include "band_analyzer.h"
+#include "oled_text.h"
+#include "spsc_queue.h"
+#include "seq_snapshot.h"
+#include "settings_blob.h"
+#include "strip_fork.h"
+#include "frame_clock.h"
+#include "fx_rng.h"
+#include "compositor.h"
+#ifndef NATIVE_BUILD
+#include <driver/adc.h>
+#endif
 
 // Forward declarations for types used in prototypes
 struct Cloud;
@@ -10,28 +28,35 @@ struct StaticPulse;  // optional (you already use 'struct StaticPulse*' in a pro
 // ---- forward declares so earlier code can see these ----
 struct EffectEntry { const char* name; void (*fn)(); }; // if not already visible here
 // --- fwd used by makeMusicFrame & MUSIC_EFFECTS ---
-uint8_t sens(uint8_t n);          // defined later (inline uses GATE_SENS_Q8)
+uint8_t sens(uint8_t n);          // defined later (scales by frameSettings().gateSensQ8)
 
 // ==== New function prototypes ====
+struct PaletteLut;
 void fx_segmentDJ();
-void renderPaletteClouds(CRGB* led, bool reverseIndex,
-                         const CRGBPalette16& pal, uint8_t baseV, Cloud* C,
-                         uint16_t t1, uint16_t t2, uint16_t t3);
+static inline void initSin8Lut();
 void spawnRipple(int center, bool isBass);
 void spawnStaticPulse(bool onStrip1, int headIdx, bool dirRight);
 void renderStaticPulses(struct StaticPulse* arr, CRGB* strip);
-void drawHome();
+void invalidateHud();
+void renderHud();
 void initNewUI();
 void uiTick();
-void handleInputs();
+void pollInputs();
+void applyInputs();
 void handlePotentiometer();
-void handleTouchButtons();
 void readMSGEQ7();
+void startMsgeq7();
+void startShowTask();
+void presentFrame();
+void startOledTask();
+void publishOled();
+uint32_t serviceOled(uint32_t nowMs);
 void fx_paletteFlow();
 void addSegmentOverlay();
 void spawnSegmentStrong(int start, int len, bool isBass, uint8_t vMax);
 void dumpIOOnce();
 static void drawFxTweakScreen();
+static void pollButtons();
 
 // ---- Palette blend control (defaults & prototypes) ----
 constexpr uint16_t PALETTE_BLEND_MS_DEFAULT = 1;   // fast manual fade
@@ -54,6 +79,20 @@ void setMusicPalette(uint8_t idx, uint16_t ms, bool instant);        // main imp
 #define RESET_PIN  13
 #define ANALOG_PIN 36
 
+// MSGEQ7 is clocked in the background by a hardware timer; loop() only
+// picks up the newest finished 7-band frame (see msgeq7_engine.h)
+struct Msgeq7Io {
+  static inline void strobe(bool high) { digitalWrite(STROBE_PIN, high ? HIGH : LOW); }
+  static inline void reset(bool high)  { digitalWrite(RESET_PIN,  high ? HIGH : LOW); }
+#ifdef NATIVE_BUILD
+  static inline bool sample(uint16_t& out) { out = analogRead(ANALOG_PIN); return true; }
+#else
+  static bool sample(uint16_t& out);   // via adcTask, see MSGEQ7 below
+#endif
+  static inline uint32_t nowUs()       { return micros(); }
+};
+static Msgeq7Engine<Msgeq7Io> msgeq7;
+
 // ---- NEW CONTROL PINS (example) ----
 #define BTN_A 17  // Laser toggle
 #define BTN_B 19  // FX: Confetti
@@ -105,7 +144,7 @@ bool displayOK = false;
 enum UiScreen { UI_HOME, UI_SETTINGS, UI_SETTINGS_MUSIC, UI_PARAM_ADJUST, UI_FX_TWEAK };
 static UiScreen ui = UI_HOME;
 static uint8_t menuCursor = 0;        // index within current menu
-static uint8_t musicCursor = 0;       // 0=Music Gate, 1=Bass, 2=Treble
+static uint8_t musicCursor = 0;       // row of MUSIC_MENU
 static uint32_t uiLastActivityMs = 0; // for 6s timeout
 const uint16_t UI_IDLE_MS = 6000;
 
@@ -115,13 +154,19 @@ static int  potEntryRaw = -1;             // raw at entry to adjust
 const  int  POT_PICKUP_DEAD = 40;         // << significant movement
 static int  potLastCommitRaw = -1;        // last raw that produced change
 
-// whats being adjusted now
-enum ParamTarget { PT_NONE, PT_MUSIC_GATE, PT_BASS, PT_TREBLE, PT_PALETTE, PT_FLASHSET, PT_SENSITIVITY, PT_LASER_GATE};
-static ParamTarget activeParam = PT_NONE;
+// Adjustable parameters (rows of PARAMS[], see PARAMETERS)
+enum ParamId : uint8_t {
+  P_MUSIC_GATE, P_BASS_GATE, P_TREBLE_GATE, P_LASER_GATE, P_SENSITIVITY,
+  P_PALETTE, P_FLASH_SET, P_STROBE_SET, P_BRIGHTNESS, P_BOUNCE_LEN, P_BOUNCE_PPS,
+  P_LASER_AUTO, P_KNOB_MODE,
+  P_COUNT
+};
+
+// whats being adjusted now (P_COUNT = nothing)
+static ParamId activeParam = P_COUNT;
 
 
-enum PotMode : uint8_t { PM_BRIGHT_MUSIC = 0, PM_BASS_TREBLE = 1 };
-static PotMode potMode = PM_BRIGHT_MUSIC;
+enum PotMode : uint8_t { PM_BRIGHT_MUSIC = 0, PM_BASS_TREBLE = 1 };   // settings.knobMode
 
 // Independent pickup for each knob
 static bool potA_pickupLocked = true, potB_pickupLocked = true;
@@ -132,35 +177,28 @@ static float g_sceneLevel = 0.0f;
 
 uint32_t suppressPalUntil = 0;
 
-// Debounce & edge state
+// Button state as the UI sees it (applied from IN_BUTTON commands)
 struct BtnState {
-  uint8_t pin;
-  bool lastLevel;
-  uint32_t lastChangeMs;
   bool pressed;      // current debounced state
-  bool fellEdge;     // press edge this tick
-  bool roseEdge;     // release edge this tick
+  bool fellEdge;     // press edge this frame
+  bool roseEdge;     // release edge this frame
 };
 static BtnState BTN[8]; // A..H (index 0..7)
-enum { BI_A, BI_B, BI_C, BI_D, BI_E, BI_F, BI_G, BI_H };
 
+// Debounce, owned by the input producer (pollButtons)
+struct BtnDebounce {
+  uint8_t  pin;
+  bool     lastLevel;
+  uint32_t lastChangeMs;
+  bool     pressed;    // debounced
+  bool     sent;       // last state queued
+};
+static BtnDebounce btnDebounce[8];
+enum { BI_A, BI_B, BI_C, BI_D, BI_E, BI_F, BI_G, BI_H };
 
-// ===== Global sensitivity (0..255). 255 = current behavior, lower = less sensitive
-uint8_t GATE_SENS_Q8 = 170;  // ~67% sensitivity to start
-inline uint8_t sens(uint8_t n) { 
-  return scale8(n, GATE_SENS_Q8);  // FastLED scale: (n * GATE_SENS_Q8) / 255
-}
 
 float smoothBands[7];
 bool strobeActive = false;
-// ---- forward decls for globals used before their definitions ----
-extern uint8_t  CLOUD_EDGE_SOFT_KNOB;
-extern uint8_t  CLOUD_SPEED_SCALE;
-extern uint8_t  SPARKLE_INTENSITY;
-
-extern uint16_t POP_FLASH_MS_K;
-extern uint16_t POP_HOLD_MS_K;
-extern uint16_t POP_FADE_MS_K;
 
 
 // ===== Palette Clouds (Music mode, non-Dark) =====
@@ -174,14 +212,64 @@ struct Cloud {
 const uint8_t CLOUD_COUNT = 4;     // how many clouds per stripmme66n6
 const float   CLOUD_MIN_LEN = 180; // base size
 const float   CLOUD_MAX_LEN = 280; // base size upper
-float   CLOUD_EDGE    = 50;  // softness (bigger = softer edges)
 const float   CLOUD_SPEED_1 =  8; // px/s for strip1 clouds (right)
 const float   CLOUD_SPEED_2 = -4; // px/s for strip2 clouds (left)
 const float   CLOUD_BREATHE = 0.1f; // 0..~0.3: how much clouds expand/contract
 
-static Cloud clouds1[CLOUD_COUNT];
-static Cloud clouds2[CLOUD_COUNT];
-static uint32_t cloudsLastUs = 0;
+// One strip's clouds plus the scratch row render() rasterises into, one
+// instance per strip so the strips render in either order or on two cores
+// at once. Only advance() moves the clouds, by the dt it is handed, so
+// motion doesn't depend on the frame rate or on how often render() runs.
+class CloudField {
+public:
+  void init(float baseSpeed, FxRng& rng);                     // random layout
+  void advance(float dt, float speedScale, uint32_t nowMs);
+  void render(CRGB* led, bool reverseIndex, const PaletteLut& pal, uint8_t baseV,
+              uint16_t t1, uint16_t t2, uint16_t t3);
+
+  Cloud c[CLOUD_COUNT];
+
+private:
+  uint8_t vBuf_[NUM_LEDS];   // mask scratch
+};
+static CloudField clouds1, clouds2;
+
+// ===== FX randomness =====
+// Every random draw an effect makes comes from its own FxRng, all derived
+// from one run seed by seedEffects(): random at boot on the device (logged,
+// so a run can be replayed), fixed on the host; harnesses pass their own.
+enum FxRngStream : uint8_t { RNG_CLOUDS, RNG_CONFETTI, RNG_SPARKLE, RNG_FLICKER };
+static FxRng    rngClouds, rngConfetti, rngSparkle, rngFlicker;
+static uint32_t fxSeed = 0;
+const uint32_t  FX_SEED_HOST = 0x5EED1337;
+static void seedEffects(uint32_t seed);   // reseeds every stream and lays the clouds out again
+
+// ============== FRAME BUDGET ==============
+// loop() is paced to TARGET_FPS and timed per stage; when the render work
+// runs over budget the controller steps down these knobs (level 0 = full).
+struct QualityKnobs {
+  uint8_t clouds;          // clouds rasterized per strip (all keep moving)
+  uint8_t shimmerSpacing;  // 1 shimmer pixel every N
+  uint8_t noiseStep;       // static pulses: inoise8 every N px (power of 2)
+};
+
+static const QualityKnobs QUALITY_LEVELS[] = {
+  { CLOUD_COUNT,      40, 1 },
+  { CLOUD_COUNT,      80, 1 },
+  { CLOUD_COUNT,      80, 2 },
+  { CLOUD_COUNT - 1, 160, 2 },
+  { CLOUD_COUNT - 2, 160, 4 },
+};
+const uint8_t QUALITY_LEVEL_COUNT = sizeof(QUALITY_LEVELS) / sizeof(QUALITY_LEVELS[0]);
+
+uint8_t TARGET_FPS = 60;               // '+' / '-' over serial
+static FrameBudget  frameBudget(TARGET_FPS, QUALITY_LEVEL_COUNT - 1);
+static FrameClock   frameClock;        // ticked once per frame: every stage's "now" and dt
+static QualityKnobs quality = QUALITY_LEVELS[0];
+
+enum BudgetReport : uint8_t { BR_OFF, BR_SUMMARY, BR_TRACE };
+static BudgetReport budgetReport = BR_OFF;  // 'u' cycles
+static uint32_t     lastBudgetPrint = 0;
 
 // --- Auto palette cycling (Music mode) ---
 bool     autoCyclePal      = false;
@@ -193,11 +281,11 @@ const uint32_t PALETTE_CYCLE_MS = 16UL * 1000UL; // 16,000 ms = 16 seconds
 // Settings menu rows (used by drawSettingsRoot / tickSettingsRoot)
 enum SettingsItem : uint8_t {
   SI_MUSIC = 0,       // "Music" -> UI_SETTINGS_MUSIC
-  SI_PALETTE,         // "Palette Color" -> PT_PALETTE
-  SI_FLASH,           // "Flash Color"   -> PT_FLASHSET
+  SI_PALETTE,         // "Palette Color" -> P_PALETTE
+  SI_FLASH,           // "Flash Color"   -> P_FLASH_SET
   SI_KNOBMODE,        // toggle Bright+Music <-> Bass+Treble
-  SI_LASER_AUTO,      // toggle LASER_AUTO_ENABLED
-  SI_LASER_GATE,      // adjust PT_LASER_GATE
+  SI_LASER_AUTO,      // toggle settings.laserAuto
+  SI_LASER_GATE,      // adjust P_LASER_GATE
   SI_COUNT
 };
 
@@ -213,14 +301,12 @@ enum ArrowMode : uint8_t {
   ARROW_BRIGHTNESS,
   ARROW_MODE_COUNT
 };
-const char* ARROW_MODE_NAMES[] = {
-  "StrobeColor", "FlashColor", "MusicGate", "BassGate", "TrebleGate", "LaserGate", "Brightness"
+const ParamId ARROW_PARAMS[ARROW_MODE_COUNT] = {
+  P_STROBE_SET, P_FLASH_SET, P_MUSIC_GATE, P_BASS_GATE, P_TREBLE_GATE, P_LASER_GATE, P_BRIGHTNESS
 };
 uint8_t arrowMode = ARROW_MUSIC_GATE;
 
-// Steps/limits for arrow adjustments
-const int     ARROW_STEP_THRESH   = 10;   // per keypress for thresholds
-const uint8_t ARROW_STEP_BRIGHT   = 5;    // per keypress for brightness
+// Brightness range (knobs, arrows)
 const uint8_t BRIGHT_MIN          = 10;
 const uint8_t BRIGHT_MAX          = 200;
 
@@ -232,7 +318,6 @@ const int     DEFAULT_TREBLE_GATE = 350;
 const uint8_t DEFAULT_FLASHSET    = 0;
 
 // === Laser control (keyboard + button) ===
-bool LASER_AUTO_ENABLED = true;   // master toggle shown in Settings
 bool laserOn = false;                           // latched state
 unsigned long laserPulseUntil = 0;              // momentary pulse deadline
 const unsigned long LASER_PULSE_MS = 250;       // 'L' key pulse length (ms)
@@ -240,7 +325,6 @@ bool laserAutoState = false; // Auto laser state (music-driven)
 unsigned long laserStrobeStart = 0;
 const unsigned long LASER_STROBE_DURATION = 500;  // ms burst length
 const uint16_t LASER_STROBE_SPEED = 60;           // ms per toggle (fast flash)
-int  LASER_GATE_THRESH = 160;   // adjust to taste (0..900 scale like bands)
 bool laserStrobeActive = false; // strobe currently running?
 unsigned long lastLaserTrigger = 0;
 
@@ -251,9 +335,8 @@ uint8_t  laserDimTarget  = 255;
 const uint16_t LASER_FADE_MS = 1000;
 
 
-bool debugBands = false;
-unsigned long lastBandsPrint = 0;
-const unsigned long BANDS_PRINT_MS = 30;
+bool telemetryOn = false;   // 'g': binary per-frame stream (see TELEMETRY)
+bool recordOn    = false;   // 'x': raw band capture for host/sim/replay_set.cpp
 
 // Optional: ASCII bar width in characters (for pretty meter)
 const uint8_t BAR_W = 20;
@@ -262,8 +345,6 @@ const uint8_t BAR_W = 20;
 // Keyboard flash (momentary)
 unsigned long flashPulseUntil = 0;
 const unsigned long FLASH_PULSE_MS = 220;
-// Touch strobe tuning
-uint16_t TOUCH_STROBE_SPEED = 70;   // ms per toggle (feel free to tune)
 
 // Flash fade tuning
 const uint8_t  FLASH_DECAY_PER_FRAME = 14; // how fast the red fades out (0..255)
@@ -274,7 +355,6 @@ const uint8_t BLACKOUT_FADE_STEP = 24; // higher = quicker fade per frame
 
 
 // ===== Music gate (0..900 scale from readMSGEQ7 mapping) =====
-int MUSIC_GATE_THRESH    = 100;  // how loud before anything shows
 const uint16_t MUSIC_GATE_HOLD = 300;  // ms to keep showing after crossing threshold
 static unsigned long musicGateOpenUntil = 0;
 
@@ -282,21 +362,14 @@ static unsigned long musicGateOpenUntil = 0;
 const uint16_t POP_FLASH_MS = 60;   // bright flash (overwrites)
 const uint16_t POP_HOLD_MS  = 250;  // hold accent color (overwrites)
 const uint16_t POP_FADE_MS  = 260;  // fade back to background
+const uint16_t POP_TOTAL_MS = POP_FLASH_MS + POP_HOLD_MS + POP_FADE_MS;   // segment lifetime
 const bool     POP_EDGE_WHITE = true; // white edge on segment during flash/hold
 
 // ----- Adaptive audio (AGC) -----
-static float bandFast[7]   = {0};   // fast envelope (current loudness)
-static float bandFloor[7]  = {0};   // adaptive noise floor per band
-static float bandCrest[7]  = {1};   // adaptive peak (headroom) per band
+// Envelope / floor / crest math lives in include/band_analyzer.h (tunables in BandTuning)
+static BandAnalyzerQ15 bandAnalyzer;
 uint8_t bandNorm[7] = {0};   // 0..255 normalized loudness per band
 
-// Tunables (good starting points)
-const float EMA_FAST   = 0.35f;   // fast envelope attack
-const float FLOOR_UP   = 0.002f;  // floor rises very slowly
-const float FLOOR_DOWN = 0.20f;   // floor falls quickly when signal drops
-const float CREST_DECAY = 0.0025f; // per frame crest decay (slow)
-const int   FLOOR_MARGIN_900 = 20; // deadband above floor (in your 0..900 scale)
-
 // --- Confetti tuning ---
 const uint16_t CONFETTI_SPAWN_MS   = 220; // how often to drop new dots (↑ = slower) 
 const uint8_t  CONFETTI_FADE       = 4;   // per-frame fade (lower = longer trails)
@@ -309,23 +382,15 @@ uint8_t audioPeakN = 0;     // max over bands, 0..255
 
 
 // ===== Dark/Music per-band gates =====
-int      BASS_GATE_THRESH   = 150;  // adjust at runtime (serial keys below)
-int      TREBLE_GATE_THRESH = 150;  // adjust at runtime
-uint16_t BASS_HIT_DEBOUNCE  = 80;   // ms min between bass segment spawns
-uint16_t TREB_HIT_DEBOUNCE  = 80;   // ms min between treble segment spawns
 const uint16_t LASER_DEBOUNCE_MS = 150;  // minimum gap between strobes
 
 // --- Bounce params ---
 static int32_t b1Vel256 = 0;            // velocity in 8.8 (strip 1)
 static int32_t b2Vel256 = 0;            // velocity in 8.8 (strip 2)
-static uint32_t bounceLastUs = 0;       // time step
 const int32_t BOUNCE_MAX_PPS     = 60;  // clamp max speed (px/s)
 const int32_t BOUNCE_KICK_DV_PPS = 40;  // per-'K' speed boost (px/s)
 
 // --- Bounce params ---
-uint16_t BOUNCE_LEN        = 50;    // visible segment length (LEDs)
-int32_t  BOUNCE_PPS        = 10;    // base speed (pixels per second)
-int32_t  BOUNCE_JOLT_PPS   = 60;    // extra speed during jolt
 const uint16_t BOUNCE_JOLT_MS    = 240;   // jolt duration (ms)
 const bool     BOUNCE_EDGE_WHITE = true;  // white tips during pop
 const uint8_t  BOUNCE_BASE_V     = 250;   // base brightness
@@ -375,13 +440,14 @@ struct Segment {
   int length;
   unsigned long startMs;
   bool bass;    // true = N, false = C
-  bool active;
   uint8_t vMax; // NEW: per-hit max brightness (0..255)
 };
 
 
-static const uint8_t MAX_SEGMENTS = 8;
-static Segment segments[MAX_SEGMENTS];
+// live segments are the pool's active list (oldest first); a full pool
+// recycles the oldest hit
+static const uint8_t MAX_SEGMENTS = 64;
+static SlotPool<Segment, MAX_SEGMENTS> segments;
 
 // --- Dark (Music) → Party segment-pop engine ---
 const uint8_t DARK_PALETTE_INDEX = 5;      // your "Dark" entry in musicPalettes[]
@@ -432,8 +498,8 @@ static inline void updateSceneLevel(uint8_t peakN) {
 
 static inline void setLaserLatched(bool on) {
   laserOn = on;
-  uiLastActivityMs = millis();
-  drawHome();
+  uiLastActivityMs = frameClock.ms();
+  invalidateHud();
 }
 
 
@@ -452,7 +518,6 @@ const FlashSet FLASH_SETS[] = {
   { CRGB::Gold,    CRGB::Red,     "Gold/Red"      },
 };
 const uint8_t FLASH_SET_COUNT = sizeof(FLASH_SETS)/sizeof(FLASH_SETS[0]);
-uint8_t flashSetIdx = 5;
 
 // ---- Strobe color SETS (two colors: strip1, strip2) ----
 struct StrobeSet { CRGB s1, s2; const char* name; };
@@ -465,7 +530,6 @@ const StrobeSet STROBE_SETS[] = {
   { CRGB::Indigo,    CRGB::Red,       "Indigo/Red"   },
 };
 const uint8_t STROBE_SET_COUNT = sizeof(STROBE_SETS)/sizeof(STROBE_SETS[0]);
-uint8_t strobeSetIdx = 0;  // <-- default strobe set on boot
 
 
 // Arrow-key parser: ESC [ A/B
@@ -473,8 +537,62 @@ enum EscState { ESC_IDLE, ESC_SEEN, ESC_BRACKET };
 static EscState escState = ESC_IDLE;
 
 
+// ============== SETTINGS ==============
+// Every tunable the render path reads. Keys, buttons, pots and the OLED menus
+// write `settings` whenever they run; once per frame, after input and before
+// anything renders, publishSettings() snapshots it. Renderers read only
+// frameSettings(), so a frame never mixes old and new values, even when the
+// strips are rendered on two cores.
+struct Settings {
+  // audio gates (0..900 scale like the bands)
+  uint8_t  gateSensQ8  = 170;   // global sensitivity, 255 = raw (~67% to start)
+  int      musicGate   = 100;   // how loud before anything shows
+  int      bassGate    = 150;
+  int      trebleGate  = 150;
+  int      laserGate   = 160;
+  uint16_t bassHitMs   = 80;    // min gap between bass segment spawns
+  uint16_t trebHitMs   = 80;    // min gap between treble segment spawns
+  bool     laserAuto   = true;  // music-driven laser (Settings menu)
+
+  // bounce
+  uint16_t bounceLen     = 50;  // visible segment length (LEDs)
+  int      bouncePps     = 10;  // base speed (px/s)
+  int      bounceJoltPps = 60;  // extra speed during jolt
+
+  // "virtual" knobs that scale existing behaviours
+  uint8_t  cloudEdgeKnob    = 50;    // 10..200 -> cloudEdge
+  uint8_t  cloudSpeedScale  = 100;   // % of base cloud speed
+  uint8_t  sparkleIntensity = 50;    // 0..100 -> sparkle probability cap
+
+  // overlays
+  uint16_t strobeMs   = 70;     // ms per strobe toggle
+  uint8_t  flashSet   = 5;
+  uint8_t  strobeSet  = 0;
+  uint8_t  palette    = 2;      // music palette, 0-based
+  uint8_t  brightness = BRIGHTNESS;
+  uint8_t  knobMode   = PM_BRIGHT_MUSIC;   // PotMode, "Knob Mode"
+
+  // derived in publishSettings()
+  float    cloudEdge  = 50;     // cloud softness (bigger = softer edges)
+};
+
+Settings settings;                          // edit copy (input / UI side)
+static SeqSnapshot<Settings> settingsSnap;  // what the frame renders with
+
+static void publishSettings() {
+  settings.cloudEdge = (float)map(settings.cloudEdgeKnob, 10, 200, 20, 90);
+  settingsSnap.publish(settings);
+  FastLED.setBrightness(settings.brightness);
+}
+
+inline const Settings& frameSettings() { return settingsSnap.get(); }
+
+inline uint8_t sens(uint8_t n) {
+  return scale8(n, frameSettings().gateSensQ8);  // (n * gateSensQ8) / 255
+}
+
+
 // ==== MUSIC PALETTES (1..9) ====
-uint8_t musicPaletteIndex = 2; // 0-based
 
 
 const CRGBPalette16 PALETTE_TEAL_MAGENTA(
@@ -561,11 +679,11 @@ const Accents ACCENT[9] = {
   { CRGB::Indigo,     CRGB::Red }    // TealMagenta
 };
 
-// Small, fast filter (8x average). ADC is cheap; this removes shimmer.
+// Left knob for the param-adjust screen: the queued (already averaged)
+// reading, on the 16-sample-sum >> 3 scale the screen has always used.
+static int potRaw[2] = { 0, 0 };   // latest knob readings, applied by applyInputs()
 static inline int readAdjPot() {
-  uint32_t sum = 0;
-  for (uint8_t i=0;i<16;i++) sum += analogRead(POT1_PIN);
-  return (int)(sum >> 3);
+  return potRaw[0] << 1;
 }
 
 inline uint8_t gateToNorm255(int thr) {
@@ -595,24 +713,284 @@ const char* musicPaletteNames[] = {
 const uint8_t MUSIC_PALETTE_COUNT = sizeof(musicPalettes)/sizeof(musicPalettes[0]);
 
 // palette state
-static CRGBPalette16 currentPal = musicPalettes[musicPaletteIndex];
-static CRGBPalette16 targetPal  = musicPalettes[musicPaletteIndex];
+static CRGBPalette16 currentPal = musicPalettes[settings.palette];
+static CRGBPalette16 targetPal  = musicPalettes[settings.palette];
+
+// time-based crossfade: currentPal = lerp(palBlendFrom, targetPal, elapsed / palBlendMs)
+static CRGBPalette16 palBlendFrom = musicPalettes[settings.palette];
+static uint16_t palBlendMs      = 0;
+static uint32_t palBlendStartMs = 0;
+static bool     palConverged    = true;    // currentPal == targetPal, nothing to step
+static uint32_t palGeneration   = 1;       // bumped whenever currentPal changes
+
+// ---- Palette LUT: currentPal expanded to 256 colors at full brightness ----
+// Renderers index this instead of calling ColorFromPalette per pixel; it is
+// only rebuilt when palGeneration moves.
+struct PaletteLut {
+  CRGB e[256];
+
+  void build(const CRGBPalette16& pal) {
+    for (int i = 0; i < 256; i++) e[i] = ColorFromPalette(pal, (uint8_t)i, 255);
+  }
+
+  // Same result as ColorFromPalette(pal, idx, V) (LINEARBLEND)
+  inline CRGB at(uint8_t idx, uint8_t V) const {
+    const CRGB& c = e[idx];
+    if (V == 255) return c;
+    if (V == 0)   return CRGB(0, 0, 0);
+    uint8_t b = V + 1;
+    return CRGB(scale8(c.r, b), scale8(c.g, b), scale8(c.b, b));
+  }
+};
+
+static PaletteLut curPalLut;
+static uint32_t   curPalLutGen = 0;        // palGeneration the LUT was built from
 
-// time-based crossfade
-static uint16_t palBlendMs   = 0;
-static uint32_t palBlendLast = 0;
+// Dark hit palettes never change; expanded once in setup()
+static PaletteLut darkBassLut, darkTrebleLut;
+
+static inline const PaletteLut& paletteLut() {
+  if (curPalLutGen != palGeneration) { curPalLut.build(currentPal); curPalLutGen = palGeneration; }
+  return curPalLut;
+}
+
+inline bool palettesEqual(const CRGBPalette16& a, const CRGBPalette16& b) {
+  return memcmp(a.entries, b.entries, sizeof(a.entries)) == 0;
+}
+
+// Jump straight to targetPal (hard cut or end of a fade)
+inline void settlePalette() {
+  if (!palettesEqual(currentPal, targetPal)) { currentPal = targetPal; palGeneration++; }
+  palBlendFrom = targetPal;
+  palConverged = true;
+}
 
 inline void stepPaletteBlend() {
-  uint32_t now = millis();
-  uint32_t dt  = now - palBlendLast;
-  palBlendLast = now;
+  if (palConverged) return;
+
+  uint32_t elapsed = frameClock.ms() - palBlendStartMs;
+  if (palBlendMs == 0 || elapsed >= palBlendMs) { settlePalette(); return; }
+
+  // per-channel lerp in Q16; only bump the generation if a byte moved
+  uint32_t f16 = (elapsed << 16) / palBlendMs;            // 0..65535
+  const uint8_t* from = (const uint8_t*)palBlendFrom.entries;
+  const uint8_t* to   = (const uint8_t*)targetPal.entries;
+  uint8_t*       cur  = (uint8_t*)currentPal.entries;
+  bool changed = false;
+  for (uint8_t i = 0; i < sizeof(currentPal.entries); i++) {
+    uint8_t v = (uint8_t)(from[i] + (((int32_t)(to[i] - from[i]) * (int32_t)f16) >> 16));
+    if (v != cur[i]) { cur[i] = v; changed = true; }
+  }
+  if (changed) palGeneration++;
+}
+
+
+// ============== PARAMETERS ==============
+// One row per user-adjustable tunable in Settings: labels, storage, range,
+// arrow/serial step and how it's shown. The OLED adjust screens, arrow keys,
+// serial nudges, knobs and telemetry all go through paramGet/paramSet, so a
+// new tunable is one Settings field plus one row here. Rows address the
+// field by offset so the same row reads the edit copy or a frame snapshot.
+// Every row is persisted under its key (see PERSISTENCE).
+enum ParamType : uint8_t { PTY_BOOL, PTY_U8, PTY_U16, PTY_INT };
+enum ParamFmt  : uint8_t { PF_NUM, PF_PCT, PF_PALETTE, PF_FLASH, PF_STROBE, PF_ONOFF, PF_KNOBS };
+
+template <typename T> constexpr ParamType paramTypeOf();
+template <> constexpr ParamType paramTypeOf<bool>()     { return PTY_BOOL; }
+template <> constexpr ParamType paramTypeOf<uint8_t>()  { return PTY_U8; }
+template <> constexpr ParamType paramTypeOf<uint16_t>() { return PTY_U16; }
+template <> constexpr ParamType paramTypeOf<int>()      { return PTY_INT; }
+
+#define PARAM_FIELD(f) (uint16_t)offsetof(Settings, f), paramTypeOf<decltype(Settings::f)>()
+
+struct ParamDef {
+  uint8_t     key;       // NVS record key; never renumber or reuse
+  const char* name;      // serial / telemetry ("BassGate")
+  const char* label;     // OLED ("Bass Gate")
+  uint16_t    offset;    // into Settings
+  ParamType   type;
+  int16_t     lo, hi;    // stored range
+  int16_t     knobLo;    // a knob sweeps knobLo..hi
+  int16_t     step;      // per arrow press / serial nudge
+  bool        wrap;      // lists wrap around instead of clamping
+  ParamFmt    fmt;
+  void      (*onChange)(uint8_t v);   // extra work after a store, or nullptr
+};
 
-  if (palBlendMs == 0) { currentPal = targetPal; return; }
-  if (dt == 0) return;
+static void paletteChanged(uint8_t v) { setMusicPalette(v); }   // starts the crossfade
+static void knobModeChanged(uint8_t) {                         // knobs pick up afresh
+  potA_pickupLocked = potB_pickupLocked = true;
+  potA_entryRaw = potB_entryRaw = -1;
+}
+
+// Lists step -1 so Up goes to the previous entry, as on the OLED menus.
+constexpr ParamDef PARAMS[P_COUNT] = {
+  {  1, "MusicGate",   "Music Gate",    PARAM_FIELD(musicGate),        0, 900,   0, 10, false, PF_NUM,     nullptr },
+  {  2, "BassGate",    "Bass Gate",     PARAM_FIELD(bassGate),         0, 900,   0, 10, false, PF_NUM,     nullptr },
+  {  3, "TrebleGate",  "Treble Gate",   PARAM_FIELD(trebleGate),       0, 900,   0, 10, false, PF_NUM,     nullptr },
+  {  4, "LaserGate",   "Laser Gate",    PARAM_FIELD(laserGate),        0, 900,   0, 10, false, PF_NUM,     nullptr },
+  {  5, "Sensitivity", "Sensitivity",   PARAM_FIELD(gateSensQ8),       0, 255,  40,  5, false, PF_PCT,     nullptr },
+  {  6, "Palette",     "Palette Color", PARAM_FIELD(palette),          0, MUSIC_PALETTE_COUNT - 1, 0, 1, true, PF_PALETTE, paletteChanged },
+  {  7, "FlashColor",  "Flash Color",   PARAM_FIELD(flashSet),         0, FLASH_SET_COUNT - 1,     0, -1, true, PF_FLASH,   nullptr },
+  {  8, "StrobeColor", "Strobe Color",  PARAM_FIELD(strobeSet),        0, STROBE_SET_COUNT - 1,    0, -1, true, PF_STROBE,  nullptr },
+  {  9, "Brightness",  "Brightness",    PARAM_FIELD(brightness),      BRIGHT_MIN, BRIGHT_MAX, BRIGHT_MIN, 5, false, PF_NUM, nullptr },
+  { 10, "BounceLen",   "Bounce Length", PARAM_FIELD(bounceLen),        5, 250,   5,  5, false, PF_NUM,     nullptr },
+  { 11, "BouncePPS",   "Bounce Speed",  PARAM_FIELD(bouncePps),        2, 120,   2,  2, false, PF_NUM,     nullptr },
+  { 12, "LaserAuto",   "Laser Auto",    PARAM_FIELD(laserAuto),        0,   1,   0,  1, true,  PF_ONOFF,   nullptr },
+  { 13, "KnobMode",    "Knob Mode",     PARAM_FIELD(knobMode),         0,   1,   0,  1, true,  PF_KNOBS,   knobModeChanged },
+};
 
-  uint32_t step32 = (dt * 255UL) / palBlendMs;      // how far to move this frame
-  uint8_t  step   = (step32 == 0) ? 1 : (step32 > 255 ? 255 : (uint8_t)step32);
-  nblendPaletteTowardPalette(currentPal, targetPal, step);
+inline int paramGet(const Settings& s, ParamId id) {
+  const ParamDef& p = PARAMS[id];
+  const uint8_t* f = (const uint8_t*)&s + p.offset;
+  switch (p.type) {
+    case PTY_BOOL: return *(const bool*)f;
+    case PTY_U8:   return *f;
+    case PTY_U16:  return *(const uint16_t*)f;
+    default:       return *(const int*)f;
+  }
+}
+
+// Unsaved changes to the edit copy (written out by serviceSettingsSave)
+static bool     settingsDirty       = false;
+static uint32_t settingsDirtySinceMs = 0, settingsChangedMs = 0;
+
+// Clamps (lists: wraps) v into range and stores it in the edit copy.
+// True when the value changed.
+static bool paramSet(ParamId id, int v) {
+  const ParamDef& p = PARAMS[id];
+  if (p.wrap) { const int n = p.hi - p.lo + 1; v = p.lo + ((v - p.lo) % n + n) % n; }
+  else        v = constrain(v, (int)p.lo, (int)p.hi);
+  if (v == paramGet(settings, id)) return false;
+
+  uint8_t* f = (uint8_t*)&settings + p.offset;
+  switch (p.type) {
+    case PTY_BOOL: *(bool*)f = v != 0; break;
+    case PTY_U8:   *f = (uint8_t)v; break;
+    case PTY_U16:  *(uint16_t*)f = (uint16_t)v; break;
+    default:       *(int*)f = v; break;
+  }
+  if (p.onChange) p.onChange((uint8_t)v);
+  invalidateHud();
+
+  settingsChangedMs = frameClock.ms();
+  if (!settingsDirty) { settingsDirty = true; settingsDirtySinceMs = settingsChangedMs; }
+  return true;
+}
+
+// dir = +1 (Up) / -1 (Down)
+static bool paramStep(ParamId id, int dir) {
+  return paramSet(id, paramGet(settings, id) + dir * PARAMS[id].step);
+}
+
+// Knob reading (0..4095) -> knobLo..hi
+static int paramFromKnob(ParamId id, int raw) {
+  const ParamDef& p = PARAMS[id];
+  return constrain((int)map(raw, 0, 4095, p.knobLo, p.hi), (int)p.knobLo, (int)p.hi);
+}
+
+static const char* paramFormat(ParamId id, int v, char* buf, size_t n) {
+  switch (PARAMS[id].fmt) {
+    case PF_PCT:     snprintf(buf, n, "%u%%", (unsigned)(v * 100 / 255)); return buf;
+    case PF_PALETTE: return musicPaletteNames[v];
+    case PF_FLASH:   return FLASH_SETS[v].name;
+    case PF_STROBE:  return STROBE_SETS[v].name;
+    case PF_ONOFF:   return v ? "ON" : "OFF";
+    case PF_KNOBS:   return v == PM_BRIGHT_MUSIC ? "Bright+Music" : "Bass+Treble";
+    default:         snprintf(buf, n, "%d", v); return buf;
+  }
+}
+
+// "BassGate=150"
+static void paramLog(ParamId id) {
+  char b[12];
+  Serial.printf("%s=%s\n", PARAMS[id].name, paramFormat(id, paramGet(settings, id), b, sizeof(b)));
+}
+
+
+// ============== PERSISTENCE ==============
+// The PARAMS rows live in NVS as one settings blob (settings_blob.h), read
+// once in setup(). A flash write stalls both cores for a few ms and wears
+// the sector, so changes are batched: serviceSettingsSave() writes only once
+// nothing has changed for SAVE_IDLE_MS (a knob sweep or key repeat is one
+// write), or SAVE_MAX_MS after the first unsaved change if edits never stop,
+// and skips the write when the blob matches what flash already holds.
+static const char* NVS_NAMESPACE = "viz";
+static const char* NVS_KEY       = "settings";
+const uint32_t SAVE_IDLE_MS = 5000;
+const uint32_t SAVE_MAX_MS  = 60000;
+
+static uint8_t  nvsBlob[SB_MAX_BYTES];     // what flash holds, as far as we know
+static size_t   nvsBlobLen     = 0;
+static uint32_t nvsWrites      = 0;
+static uint32_t nvsWriteFails  = 0;
+static SbStatus settingsLoadStatus = SB_EMPTY;
+static uint8_t  settingsLoaded = 0;        // records applied at boot
+
+static size_t encodeSettings(const Settings& s, uint8_t* out, size_t cap) {
+  SettingsRecord r[P_COUNT];
+  for (uint8_t i = 0; i < P_COUNT; i++) r[i] = { PARAMS[i].key, (int16_t)paramGet(s, (ParamId)i) };
+  return sbEncode(r, P_COUNT, out, cap);
+}
+
+// Boot: stored values over the defaults, each through paramSet so it's
+// clamped like any other input. Anything wrong with the blob -> defaults.
+static void loadSettings() {
+  const uint32_t t0 = micros();
+  SettingsRecord rec[SB_MAX_RECORDS];
+  uint8_t n = 0;
+  size_t len = 0;
+  settingsLoadStatus = SB_EMPTY;
+  settingsLoaded = 0;
+
+  Preferences nvs;
+  if (nvs.begin(NVS_NAMESPACE, true)) {     // fails until the first save
+    len = nvs.getBytesLength(NVS_KEY);
+    if (len > SB_MAX_BYTES) settingsLoadStatus = SB_LENGTH;
+    else if (len) settingsLoadStatus = sbDecode(nvsBlob, nvs.getBytes(NVS_KEY, nvsBlob, len), rec, SB_MAX_RECORDS, n);
+    nvs.end();
+  }
+
+  if (settingsLoadStatus == SB_OK) {
+    nvsBlobLen = len;
+    for (uint8_t i = 0; i < n; i++)
+      for (uint8_t id = 0; id < P_COUNT; id++)
+        if (PARAMS[id].key == rec[i].key) { paramSet((ParamId)id, rec[i].value); settingsLoaded++; break; }
+    settlePalette();                        // boot on the stored palette, no crossfade
+  } else {
+    nvsBlobLen = 0;
+  }
+  settingsDirty = false;                    // flash already holds what we just read
+
+  if (settingsLoadStatus == SB_OK)
+    Serial.printf("Settings: %u/%u from NVS in %luus\n", settingsLoaded, (unsigned)n, (unsigned long)(micros() - t0));
+  else
+    Serial.printf("Settings: defaults (%s)\n", SB_STATUS_NAMES[settingsLoadStatus]);
+}
+
+// Once per frame, after input.
+static void serviceSettingsSave(uint32_t now) {
+  if (!settingsDirty) return;
+  if (now - settingsChangedMs < SAVE_IDLE_MS && now - settingsDirtySinceMs < SAVE_MAX_MS) return;
+  settingsDirty = false;
+
+  uint8_t buf[sbSize(P_COUNT)];
+  const size_t len = encodeSettings(settings, buf, sizeof(buf));
+  if (len == nvsBlobLen && !memcmp(buf, nvsBlob, len)) return;   // changed and changed back
+
+  Preferences nvs;
+  bool ok = nvs.begin(NVS_NAMESPACE, false) && nvs.putBytes(NVS_KEY, buf, len) == len;
+  nvs.end();
+  if (!ok) {                                // try again after another idle period
+    nvsWriteFails++;
+    settingsDirty = true;
+    settingsDirtySinceMs = settingsChangedMs = now;
+    Serial.println("Settings: NVS write failed");
+    return;
+  }
+  memcpy(nvsBlob, buf, len);
+  nvsBlobLen = len;
+  nvsWrites++;
 }
 
 
@@ -623,13 +1001,13 @@ static uint8_t  flickerSeed   = 0;
 
 // Call every frame before drawing bursts to advance flicker
 inline void advanceFlicker() {
-  uint32_t now = millis();
+  uint32_t now = frameClock.ms();
   // ~30 Hz base flicker; jitter a bit so it doesn’t feel mechanical
   static uint8_t jitter = 0;
-  if (now - flickerTickMs > (28 + jitter)) {
+  if (now - flickerTickMs > 28u + jitter) {
     flickerTickMs = now;
-    flickerSeed = random8();
-    jitter = random8(0, 10); // 0–9 ms
+    flickerSeed = rngFlicker.u8();
+    jitter = rngFlicker.u8(0, 10); // 0–9 ms
   }
 }
 
@@ -663,6 +1041,8 @@ enum PotRole : uint8_t {
   PR_CONFETTI_BRIGHT
 };
 static PotRole potRole = PR_NONE;
+// Left knob's parameter per role; PR_NONE follows "Knob Mode"
+const ParamId POT_ROLE_PARAM[] = { P_COUNT, P_BRIGHTNESS, P_BOUNCE_LEN, P_BOUNCE_PPS, P_BRIGHTNESS };
 static int     potPickupRaw = -1;
 static bool    potPickup    = true;
 
@@ -731,24 +1111,246 @@ void printBandsBars() {
 
 
 
+// ============== TELEMETRY ==============
+// With 'g' on, every frame queues one COBS/CRC packet (include/telemetry.h)
+// into tlmTx; telemetryPump() hands the UART only what fits in its FIFO, so
+// nothing in loop() waits on 115200 baud. If the ring is full the newest
+// packet is dropped whole (the seq gap shows up in plotter.py).
+// With 'x' on, readMSGEQ7() also queues every raw frame it consumes
+// (TLM_TYPE_RAW, 24 bytes on the wire); record.py saves the stream to a
+// file for offline replay.
+static TxRing<1024> tlmTx;
+static uint16_t     tlmSeq = 0;
+static uint16_t     rawSeq = 0;
+
+static inline uint16_t tlmQ2(float v) { return (uint16_t)constrain((int32_t)lroundf(v * 4.0f), 0, 65535); }
+
+static void sendTelemetry() {
+  TelemetryFrame f;
+  f.seq = tlmSeq++;
+  f.ms  = frameClock.ms();
+  for (int i = 0; i < 7; i++) {
+    f.smooth[i]  = (uint16_t)constrain((int)smoothBands[i], 0, 65535);
+    f.norm[i]    = bandNorm[i];
+    f.floorQ2[i] = tlmQ2(bandAnalyzer.floor900(i));
+    f.crestQ2[i] = tlmQ2(bandAnalyzer.crest900(i));
+  }
+  f.peakN    = audioPeakN;
+  f.sceneQ15 = (uint16_t)(constrain(g_sceneLevel, 0.f, 1.f) * 32767.0f);
+  const Settings& fs = frameSettings();   // the gates this frame ran with
+  static const ParamId TLM_GATES[4] = { P_MUSIC_GATE, P_BASS_GATE, P_TREBLE_GATE, P_LASER_GATE };
+  for (uint8_t i = 0; i < 4; i++) f.gates[i] = (uint16_t)paramGet(fs, TLM_GATES[i]);
+  for (uint8_t i = 0; i < TLM_STAGES; i++)
+    f.stageUs[i] = (uint16_t)min<uint32_t>(frameBudget.stageUs((FrameStage)i), 65535);
+  f.quality = frameBudget.level();
+
+  uint8_t payload[TLM_PAYLOAD_LEN], wire[TLM_WIRE_MAX];
+  size_t n = frameTelemetry(payload, encodeTelemetry(f, payload), wire);
+  tlmTx.push(wire, n);
+}
+
+static void sendRawBands(const Msgeq7Frame& frame) {
+  RawBandsFrame r;
+  r.seq = rawSeq++;
+  r.us  = frameClock.us();
+  for (int i = 0; i < 7; i++) r.raw[i] = frame.raw[i];
+
+  uint8_t payload[TLM_RAW_LEN], wire[TLM_WIRE_MAX];
+  size_t n = frameTelemetry(payload, encodeRawBands(r, payload), wire);
+  tlmTx.push(wire, n);
+}
+
+static void telemetryPump() {
+  const uint8_t* p;
+  size_t n = tlmTx.peek(p);
+  if (!n) return;
+  int room = Serial.availableForWrite();
+  if (room <= 0) return;
+  if (n > (size_t)room) n = (size_t)room;
+  tlmTx.consume(Serial.write(p, n));
+}
+
+// ============== SHOW PIPELINE ==============
+// loop() (core 1) renders into leds1/leds2 as before, then presentFrame()
+// copies them into the back slot of a lock-free triple buffer. showTask on
+// core 0 owns FastLED.show(): it points both controllers at the newest slot
+// and pushes it out while loop() is already rendering the next frame.
+struct LedFrame { CRGB s1[NUM_LEDS]; CRGB s2[NUM_LEDS]; };
+static FrameExchange<LedFrame> ledFrames;
+
+// Per-strip render work forks strip 2 (index 1) to a worker on core 0,
+// below showTask; loop() keeps strip 1 and joins before compositing.
+static StripForkJoin stripFork;
+
+#ifndef NATIVE_BUILD
+static TaskHandle_t showTaskHandle   = nullptr;
+static TaskHandle_t renderTaskHandle = nullptr;
+const  uint32_t     SHOW_WAIT_MS     = 60;   // > 2 strips of wire time
+
+static void showTask(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (!ledFrames.acquire()) continue;
+    LedFrame& f = ledFrames.front();
+    FastLED[0].setLeds(f.s1, NUM_LEDS);
+    FastLED[1].setLeds(f.s2, NUM_LEDS);
+    xTaskNotifyGive(renderTaskHandle);    // slot taken: next frame may publish
+    FastLED.show();
+  }
+}
+#endif
+
+// CALL ONCE in setup() after FastLED.addLeds (also starts the strip worker)
+void startShowTask() {
+#ifndef NATIVE_BUILD
+  renderTaskHandle = xTaskGetCurrentTaskHandle();   // Arduino loop task
+  xTaskCreatePinnedToCore(showTask, "ledShow", 4096, nullptr, configMAX_PRIORITIES - 2,
+                          &showTaskHandle, 0);
+  stripFork.begin(0, configMAX_PRIORITIES - 3);
+#endif
+}
+
+// Replaces FastLED.show() at the end of loop()
+void presentFrame() {
+#ifdef NATIVE_BUILD
+  FastLED.show();
+#else
+  // Pace to the wire: if the last frame is still waiting, let show pick it up
+  // first (one frame of overlap, never more). Otherwise just clear stale gives.
+  ulTaskNotifyTake(pdTRUE, ledFrames.pending() ? pdMS_TO_TICKS(SHOW_WAIT_MS) : 0);
+
+  LedFrame& back = ledFrames.back();
+  memcpy(back.s1, leds1, sizeof(leds1));
+  memcpy(back.s2, leds2, sizeof(leds2));
+  ledFrames.publish();
+  xTaskNotifyGive(showTaskHandle);
+#endif
+}
+
+
+// ============== OLED ==============
+// The draw*() screens only compose text into `oled` (oled_text.h): no
+// pixels, no I2C, so callers can redraw as often as they like. Once per
+// loop() publishOled() hands a changed screen over through a triple buffer.
+// oledTask (core 0, below showTask) diffs the newest screen against what the
+// panel shows, renders just the changed rows into the GFX buffer and pushes
+// those pages (128 B each instead of the full 1 KB), at most OLED_MAX_HZ;
+// screens published in between are coalesced.
+static OledText oled;
+static FrameExchange<OledScreen> oledScreens;
+static OledScreen oledPublished;           // loop side: last screen handed over
+static OledScreen oledShown;               // flush side: what the panel shows
+static uint8_t    oledAddr = SCREEN_ADDR;  // whichever address begin() found
+const  uint8_t    OLED_MAX_HZ   = 10;
+const  uint32_t   OLED_MIN_MS   = 1000 / OLED_MAX_HZ;
+const  uint8_t    OLED_I2C_CHUNK = 32;     // data bytes per transfer (Wire buffer is 128)
+static uint32_t   oledLastFlushMs = 0;
+static uint32_t   oledPagesPushed = 0;
+
+static void pushOledPage(uint8_t page) {
+  display.ssd1306_command(SSD1306_PAGEADDR);
+  display.ssd1306_command(page);
+  display.ssd1306_command(page);
+  display.ssd1306_command(SSD1306_COLUMNADDR);
+  display.ssd1306_command(0);
+  display.ssd1306_command(SCREEN_WIDTH - 1);
+  const uint8_t* p = display.getBuffer() + (uint16_t)page * SCREEN_WIDTH;
+  for (uint8_t i = 0; i < SCREEN_WIDTH; i += OLED_I2C_CHUNK) {
+    Wire.beginTransmission(oledAddr);
+    Wire.write((uint8_t)0x40);                 // control byte: data follows
+    Wire.write(p + i, OLED_I2C_CHUNK);
+    Wire.endTransmission();
+  }
+  oledPagesPushed++;
+}
+
+// Flush side: bring the panel up to the newest published screen.
+static void flushOled() {
+  if (!oledScreens.acquire()) return;
+  const OledScreen& s = oledScreens.front();
+  uint8_t dirty = oledDiff(s, oledShown);
+  for (uint8_t r = 0; r < OLED_ROWS; r++) {
+    if (!(dirty & (1u << r))) continue;
+    display.fillRect(0, r * OLED_CHAR_H, SCREEN_WIDTH, OLED_CHAR_H, SSD1306_BLACK);
+    display.setCursor(0, r * OLED_CHAR_H);
+    display.print(s.rows[r]);
+    pushOledPage(r);
+    memcpy(oledShown.rows[r], s.rows[r], sizeof(s.rows[r]));
+  }
+}
+
+// Flushes if a screen is waiting and the rate limit allows; otherwise
+// returns how many ms to wait before trying again. Called by oledTask on the
+// rig and by host/sim/oled_traffic.cpp, so not static: other host builds
+// have no caller.
+uint32_t serviceOled(uint32_t nowMs) {
+  if (!oledScreens.pending()) return 0;
+  uint32_t since = nowMs - oledLastFlushMs;
+  if (since < OLED_MIN_MS) return OLED_MIN_MS - since;
+  oledLastFlushMs = nowMs;
+  flushOled();
+  return 0;
+}
+
+#ifndef NATIVE_BUILD
+static TaskHandle_t oledTaskHandle = nullptr;
+
+static void oledTask(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    uint32_t waitMs;
+    while ((waitMs = serviceOled(millis())) > 0) vTaskDelay(max<TickType_t>(1, pdMS_TO_TICKS(waitMs)));
+  }
+}
+#endif
+
+// CALL ONCE in setup() after display.begin; from here on only oledTask
+// touches the display and the I2C bus.
+void startOledTask() {
+  if (!displayOK) return;
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+  display.setTextWrap(false);              // rows are already wrapped by OledText
+#ifndef NATIVE_BUILD
+  xTaskCreatePinnedToCore(oledTask, "oled", 3072, nullptr, 1, &oledTaskHandle, 0);
+#endif
+}
+
+// Loop side, once per pass. On the host there is no second core: the
+// harness calls serviceOled() itself when it wants the bus traffic.
+void publishOled() {
+  if (!displayOK || !oledDiff(oled.screen(), oledPublished)) return;
+  oledPublished = oled.screen();
+  oledScreens.back() = oledPublished;
+  oledScreens.publish();
+#ifndef NATIVE_BUILD
+  xTaskNotifyGive(oledTaskHandle);
+#endif
+}
+
+
 // ============== SETUP ==============
 void setup() {
   Serial.begin(115200);
+  frameClock.reset(micros(), millis());   // setup's own timestamps read this too
+  darkBassLut.build(PALETTE_DARK_BASS);
+  darkTrebleLut.build(PALETTE_DARK_TREBLE);
+  initSin8Lut();                   // before the strips can render on two cores
 
     // Start I2C explicitly on ESP32 default pins
   Wire.begin(21, 22);              // SDA=21, SCL=22
   Wire.setClock(400000);           // (optional) fast mode
 
   // Try both 0x3C and 0x3D so we don't get stuck on the wrong addr
-  displayOK = display.begin(SSD1306_SWITCHCAPVCC, 0x3C) ||
-              display.begin(SSD1306_SWITCHCAPVCC, 0x3D);
+  if      (display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) { displayOK = true; oledAddr = 0x3C; }
+  else if (display.begin(SSD1306_SWITCHCAPVCC, 0x3D)) { displayOK = true; oledAddr = 0x3D; }
 
   if (!displayOK) {
     Serial.println("OLED init failed — continuing headless.");
   } else {
     display.clearDisplay();
-    display.display();
-    drawHome();
+    display.display();                     // panel now matches oledShown (blank)
+    startOledTask();
   }
 
   // === Add in setup() after Serial.begin(...) ===
@@ -760,30 +1362,28 @@ analogSetPinAttenuation(POT2_PIN, ADC_11db);  // GPIO 15 is ADC2; fine if WiFi i
     initNewUI();
 
 
-  bounceLastUs = micros();
+  loadSettings();
+  publishSettings();          // renderers may run before the first loop()
+
 b1Pos256 = 0;                                           // start at left
-b2Pos256 = (int32_t)(NUM_LEDS - BOUNCE_LEN) << 8;       // start at right
-b1Vel256 =  (BOUNCE_PPS * 256);                         // move →
-b2Vel256 = -(BOUNCE_PPS * 256);                         // move ←
+b2Pos256 = (int32_t)(NUM_LEDS - settings.bounceLen) << 8;       // start at right
+b1Vel256 =  (settings.bouncePps * 256);                         // move →
+b2Vel256 = -(settings.bouncePps * 256);                         // move ←
 b1DirRight = true;
 b2DirRight = false;
 
   FastLED.addLeds<CHIPSET, DATA_PIN_1, COLOR_ORDER>(leds1, NUM_LEDS);
   FastLED.addLeds<CHIPSET, DATA_PIN_2, COLOR_ORDER>(leds2, NUM_LEDS);
-  FastLED.setBrightness(BRIGHTNESS);
+  FastLED.setBrightness(settings.brightness);
+  startShowTask();
 
-  // --- init drifting palette clouds ---
-auto initClouds = [](Cloud* C, float baseSpeed){
-  for (uint8_t i=0;i<CLOUD_COUNT;i++){
-    C[i].center = random16(NUM_LEDS);
-    C[i].length = (float)random((long)CLOUD_MIN_LEN, (long)CLOUD_MAX_LEN);
-    C[i].speed  = baseSpeed * (0.7f + (random8()/255.0f)*0.6f); // ±30% variation
-    C[i].wobble = random16(); // random phase
-  }
-};
-initClouds(clouds1, CLOUD_SPEED_1);
-initClouds(clouds2, CLOUD_SPEED_2);
-cloudsLastUs = micros();
+  // --- effect randomness + drifting palette clouds ---
+#ifdef NATIVE_BUILD
+  seedEffects(FX_SEED_HOST);
+#else
+  seedEffects(esp_random());
+#endif
+  Serial.printf("FX seed: 0x%08lx\n", (unsigned long)fxSeed);
 
   pinMode(STROBE_PIN, OUTPUT);
   pinMode(RESET_PIN, OUTPUT);
@@ -791,155 +1391,189 @@ cloudsLastUs = micros();
 
   digitalWrite(STROBE_PIN, HIGH);
   digitalWrite(RESET_PIN,  LOW);
+  startMsgeq7();
 
   pinMode(LASER_PIN, OUTPUT);
   digitalWrite(LASER_PIN, LOW);
 }
 
+// Close the frame's timing, apply a quality change and report it
+static void endFrameBudget() {
+  int8_t moved = frameBudget.end();
+  if (telemetryOn) sendTelemetry();   // this frame's stage timings are final here
+  if (moved) {
+    quality = QUALITY_LEVELS[frameBudget.level()];
+    Serial.printf("Budget: q%u (%s) work~%luus / %luus  clouds=%u shimmer=1/%u noise=1/%u\n",
+                  frameBudget.level(), moved > 0 ? "over, degrading" : "headroom, restoring",
+                  (unsigned long)frameBudget.emaUs(), (unsigned long)frameBudget.periodUs(),
+                  quality.clouds, quality.shimmerSpacing, quality.noiseStep);
+  }
+
+  if (budgetReport == BR_TRACE) {
+    // one CSV line per frame; host/sim/budget_replay.cpp reads these back
+    Serial.print("BT");
+    for (uint8_t i = 0; i < FS_COUNT; i++) { Serial.print(','); Serial.print(frameBudget.stageUs((FrameStage)i)); }
+    Serial.println();
+  } else if (budgetReport == BR_SUMMARY && frameClock.ms() - lastBudgetPrint >= 1000) {
+    lastBudgetPrint = frameClock.ms();
+    Serial.printf("Budget q%u fps=%u work~%luus/%luus overruns=%lu |",
+                  frameBudget.level(), frameBudget.targetFps(),
+                  (unsigned long)frameBudget.emaUs(), (unsigned long)frameBudget.periodUs(),
+                  (unsigned long)frameBudget.overruns());
+    for (uint8_t i = 0; i < FS_COUNT; i++)
+      Serial.printf(" %s=%lu", FRAME_STAGE_NAMES[i], (unsigned long)frameBudget.stageUs((FrameStage)i));
+    Serial.println();
+  }
+}
+
+// ============== OVERLAYS ==============
+// What loop() used to paint over the effect pass by pass, now a layer stack
+// (include/compositor.h), bottom to top: flash, strobe, laser dim - or only
+// the blackout fade. Built before the effect so an opaque stack (strobe,
+// full flash, finished blackout) can skip rendering it.
+static Compositor overlay;
+static uint8_t    flashLevel    = 0;   // 0..255, decays after the pulse
+static uint8_t    blackoutLevel = 0;   // fade-to-black progress, 255 = black
+
+static void buildOverlayLayers() {
+  overlay.clear();
+  if (blackoutActive) {
+    blackoutLevel = qadd8(blackoutLevel, BLACKOUT_FADE_STEP);
+    overlay.add(BM_FADE, blackoutLevel);
+    return;
+  }
+  blackoutLevel = 0;
+
+  const unsigned long nowMs = frameClock.ms();
+  const Settings& fs = frameSettings();
+
+  // Touch / key flash
+  bool flashPressed = flashHeldTouch || (nowMs < flashPulseUntil);
+  if (flashPressed) flashLevel = 255;
+  else if (flashLevel > 0) flashLevel = (flashLevel > FLASH_DECAY_PER_FRAME) ? (flashLevel - FLASH_DECAY_PER_FRAME) : 0;
+  if (flashLevel > 0) {
+    CRGB c1 = FLASH_SETS[fs.flashSet].s1;
+    CRGB c2 = FLASH_SETS[fs.flashSet].s2;
+    c1.nscale8_video(flashLevel);
+    c2.nscale8_video(flashLevel);
+    overlay.add(BM_OVER, flashLevel, c1, c2);
+  }
+
+  // Effect strobe (keyboard/touch): on = strobe colors, off = black
+  if (strobeActive || strobeFromKey) {
+    if (((nowMs / fs.strobeMs) & 1) == 0)
+      overlay.add(BM_OVER, 255, STROBE_SETS[fs.strobeSet].s1, STROBE_SETS[fs.strobeSet].s2);
+    else
+      overlay.add(BM_OVER, 255, CRGB::Black, CRGB::Black);
+  }
+
+  // ----- Dim LEDs when laser is toggled -----
+  uint32_t dt = frameClock.dtMs();
+  if (dt > 40) dt = 40; // clamp for stalls
+  if (laserDim != laserDimTarget) {
+    // how much to move this frame (0..255 over LASER_FADE_MS)
+    uint16_t step = (uint16_t)((255UL * dt) / LASER_FADE_MS);
+    if (step == 0) step = 1;
+    if (laserDim < laserDimTarget) laserDim = (uint8_t)min<uint16_t>(255, laserDim + step);
+    else                           laserDim = (uint8_t)max<int>(0, laserDim - step);
+  }
+  overlay.add(BM_DIM, laserDim);   // dropped at 255
+}
+
+// ----- Unified LASER auto strobe gate (all palettes, Music mode) -----
+static void updateLaserAuto(uint8_t peakN) {
+  const Settings& fs = frameSettings();
+  if (!fs.laserAuto) return;
+  unsigned long now = frameClock.ms();
+  if (normTo900(peakN) >= fs.laserGate) {
+    if (!laserStrobeActive && (now - lastLaserTrigger > LASER_DEBOUNCE_MS)) {
+      laserStrobeActive = true;
+      laserStrobeStart  = now;
+      lastLaserTrigger  = now;
+    }
+  }
+}
+
 // ============== LOOP ==============
 void loop() {
+  telemetryPump();                            // drain a little on every pass, paced or not
+  publishOled();                              // screens drawn since the last pass
+  const uint32_t frameUs = micros();
+  if (!frameBudget.due(frameUs)) return;      // hold TARGET_FPS
+  frameBudget.begin(frameUs);
+  frameClock.tick(frameUs);                   // this frame's "now" for every stage below
+
   stepPaletteBlend();          
   // ----- Auto palette cycling (Music mode) -----
 if (currentMode == MUSIC_MODE && autoCyclePal) {
-  unsigned long now = millis();
+  unsigned long now = frameClock.ms();
   if ((long)(now - nextPaletteCycle) >= 0) {
-    uint8_t next = (musicPaletteIndex + 1) % MUSIC_PALETTE_COUNT;
-    // for auto cycle we do NOT boost (gentler crossfade)
-    setMusicPalette(next);
+    paramStep(P_PALETTE, +1);   // gentle default crossfade, no boost
     nextPaletteCycle = now + PALETTE_CYCLE_MS;
   }
 }
 
-  handleInputs();
+  pollInputs();
+  applyInputs();               // everything queued since last frame, before any rendering
+  frameBudget.mark(FS_INPUT, micros());
   uiTick();
-
-  CLOUD_EDGE = (float)map(CLOUD_EDGE_SOFT_KNOB, 10, 200, 20, 90);
+  renderHud();                 // one HUD redraw at most, whatever the inputs did
+  frameBudget.mark(FS_UI, micros());
 
   handlePotentiometer();
-  handleTouchButtons();
+  publishSettings();           // render path reads this snapshot until the next frame
+  serviceSettingsSave(frameClock.ms());
   laserAutoState = false;
+  frameBudget.mark(FS_INPUT, micros());
+
+  buildOverlayLayers();        // before the effect: an opaque stack skips it
+  frameBudget.mark(FS_OVERLAY, micros());     // stack build (flash decay, dim ramp); apply adds below
 
   if (currentMode == MUSIC_MODE) {
     readMSGEQ7();
     updateSceneLevel(sens(audioPeakN));
-    fx_paletteFlow();                  // single music renderer
-  } else {
-    FX[currentEffect].fn();            // manual FX
+    updateLaserAuto(sens(audioPeakN));
+    frameBudget.mark(FS_AUDIO, micros());
   }
-
-  // ===== Blackout short-circuit =====
-  if (blackoutActive) {
-    fadeToBlackBy(leds1, NUM_LEDS, BLACKOUT_FADE_STEP);
-    fadeToBlackBy(leds2, NUM_LEDS, BLACKOUT_FADE_STEP);
-    FastLED.show();
-    digitalWrite(LASER_PIN, LOW);
-    return;
+  if (!overlay.coversBase()) {
+    if (currentMode == MUSIC_MODE) fx_paletteFlow();   // single music renderer
+    else FX[currentEffect].fn();                       // manual FX
   }
+  frameBudget.mark(FS_EFFECT, micros());
 
-  // ===== Touch overlays (flash) =====
-  const unsigned long nowMs = millis();
-  static uint8_t flashLevel = 0;  // 0..255
-  bool flashPressed = flashHeldTouch || (nowMs < flashPulseUntil);
-  if (flashPressed) flashLevel = 255;
-  else if (flashLevel > 0) flashLevel = (flashLevel > FLASH_DECAY_PER_FRAME) ? (flashLevel - FLASH_DECAY_PER_FRAME) : 0;
-
-  if (flashLevel > 0) {
-    CRGB c1 = FLASH_SETS[flashSetIdx].s1;
-    CRGB c2 = FLASH_SETS[flashSetIdx].s2;
-    c1.nscale8_video(flashLevel);
-    c2.nscale8_video(flashLevel);
-    for (int i = 0; i < NUM_LEDS; i++) {
-      nblend(leds1[i], c1, flashLevel);
-      nblend(leds2[i], c2, flashLevel);
-    }
-  }
+  overlay.apply(leds1, NUM_LEDS, 0);
+  overlay.apply(leds2, NUM_LEDS, 1);
+  frameBudget.mark(FS_OVERLAY, micros());     // flash, strobe, dim and blackout in one pass
 
   // --- LASER OUTPUT DRIVE (strobe burst stays same as your code) ---
+  const unsigned long nowMs = frameClock.ms();
   bool autoLaserNow = false;
   if (laserStrobeActive) {
-    unsigned long elapsed = millis() - laserStrobeStart;
+    unsigned long elapsed = nowMs - laserStrobeStart;
     if (elapsed >= LASER_STROBE_DURATION) {
       laserStrobeActive = false;
     } else {
       autoLaserNow = ((elapsed / LASER_STROBE_SPEED) % 2) == 0;
     }
   }
-  bool laserNow = laserOn || (millis() < laserPulseUntil) || autoLaserNow || laserAutoState;
+  bool laserNow = !blackoutActive &&
+                  (laserOn || (nowMs < laserPulseUntil) || autoLaserNow || laserAutoState);
   digitalWrite(LASER_PIN, laserNow ? HIGH : LOW);
 
-  // Effect strobe (keyboard/touch)
-  bool strobeNow = (strobeActive || strobeFromKey);
-  if (strobeNow) {
-    bool strobeOn = (((nowMs / TOUCH_STROBE_SPEED) & 1) == 0);
-    if (strobeOn) {
-      const CRGB s1 = STROBE_SETS[strobeSetIdx].s1;
-      const CRGB s2 = STROBE_SETS[strobeSetIdx].s2;
-      fill_solid(leds1, NUM_LEDS, s1);
-      fill_solid(leds2, NUM_LEDS, s2);
-    } else {
-      fill_solid(leds1, NUM_LEDS, CRGB::Black);
-      fill_solid(leds2, NUM_LEDS, CRGB::Black);
-    }
-  }
-
-  if (debugBands && millis() - lastBandsPrint >= BANDS_PRINT_MS) {
-    lastBandsPrint = millis();
-    printBandsLine();
-    // printBandsBars();
-  }
-
-  // ----- Dim LEDs when laser is toggled -----
-static uint32_t lastDimMs = millis();
-uint32_t nowMsDim = millis();
-uint32_t dt = nowMsDim - lastDimMs;
-if (dt > 40) dt = 40; // clamp for stalls
-lastDimMs = nowMsDim;
-
-if (laserDim != laserDimTarget) {
-  // how much to move this frame
-  // (0..255 over LASER_FADE_MS)
-  uint16_t step = (uint16_t)((255UL * dt) / LASER_FADE_MS);
-  if (step == 0) step = 1;
-
-  if (laserDim < laserDimTarget) {
-    laserDim = (uint8_t)min<uint16_t>(255, laserDim + step);
-  } else {
-    laserDim = (uint8_t)max<int>(0, laserDim - step);
-  }
-}
-
-// Apply dim after all overlays/strobes are drawn, unless blackout
-if (!blackoutActive) {
-  // Scale both strips by laserDim (0=black, 255=full)
-  if (laserDim < 255) {
-    nscale8_video(leds1, NUM_LEDS, laserDim);
-    nscale8_video(leds2, NUM_LEDS, laserDim);
-  }
-}
-
-
-  FastLED.show();
-}
-
-
-// ============== TOUCH / BUTTONS ==============
-void handleTouchButtons() {
-  strobeActive   = (touchRead(EFFECT_PIN) < touchThreshold);
-  flashHeldTouch = (touchRead(FLASH_PIN)  < touchThreshold);
-
-
+  presentFrame();
+  frameBudget.mark(FS_SHOW, micros());
+  endFrameBudget();
 }
 
 
-
 // ============== POT ==============
 void handlePotentiometer() {
   // Dedicated param-adjust screen owns the left knob; ignore both to avoid conflicts
   if (ui == UI_PARAM_ADJUST) return;
 
-  // --- Read both knobs raw ---
-  int rawA = analogRead(POT1_PIN); // left knob (legacy POT)
-  int rawB = analogRead(POT2_PIN); // right knob (new POT)
+  // --- Latest knob readings (queued by pollInputs) ---
+  int rawA = potRaw[0]; // left knob (legacy POT)
+  int rawB = potRaw[1]; // right knob (new POT)
 
   // --- Pickup (per-knob) ---
   if (potA_entryRaw < 0) potA_entryRaw = rawA;
@@ -951,55 +1585,29 @@ void handlePotentiometer() {
   if (allowA) potA_pickupLocked = false;
   if (allowB) potB_pickupLocked = false;
 
-  // Helpers
-  auto mapBright = [&](int r)->int {
-    return constrain(map(r, 0, 4095, BRIGHT_MIN, BRIGHT_MAX), BRIGHT_MIN, BRIGHT_MAX);
-  };
-  auto mapGate = [&](int r)->int {
-    return constrain(map(r, 0, 4095, 0, 900), 0, 900);
-  };
-
   // === LEFT KNOB (keeps your FX tweak routing when in FX tweak UI) ===
   PotRole newRole = computePotRole(); // your existing router (HOME=brightness, FX tweak, etc.)
   if (newRole != potRole) { potRole = newRole; potPickupRaw = -1; potPickup = true; }
 
-  if (potRole == PR_HOME_BRIGHT && allowA) {
-    FastLED.setBrightness(mapBright(rawA));
-  } else if (potRole == PR_CONFETTI_BRIGHT && allowA) {
-    FastLED.setBrightness(mapBright(rawA));
-  } else if (potRole == PR_BOUNCE_LEN && allowA) {
-    uint16_t L = (uint16_t)map(rawA, 0, 4095, 5, 250);
-    BOUNCE_LEN = constrain(L, 5, 250);
-  } else if (potRole == PR_BOUNCE_SPEED && allowA) {
-    int v = map(rawA, 0, 4095, 2, 120);
-    BOUNCE_PPS = constrain(v, 2, 120);
-  } else {
-    // When not in a special FX tweak role, apply the selected "Knob Mode" default for LEFT
-    if (allowA) {
-      if (potMode == PM_BRIGHT_MUSIC) {
-        FastLED.setBrightness(mapBright(rawA)); // default: brightness
-      } else { // PM_BASS_TREBLE
-        BASS_GATE_THRESH = mapGate(rawA);
-      }
-    }
+  if (allowA) {
+    ParamId left = POT_ROLE_PARAM[potRole];
+    if (left == P_COUNT) left = (settings.knobMode == PM_BRIGHT_MUSIC) ? P_BRIGHTNESS : P_BASS_GATE;  // "Knob Mode"
+    paramSet(left, paramFromKnob(left, rawA));
   }
 
 // === RIGHT KNOB ===
 if (allowB) {
   if (currentMode == FX_MODE && currentEffect == FX_BOUNCE) {
     // Right knob = speed when Bounce is active
-    int v = map(rawB, 0, 4095, 2, 120);
-    BOUNCE_PPS = constrain(v, 2, 120);
-    uiLastActivityMs = millis();
+    paramSet(P_BOUNCE_PPS, paramFromKnob(P_BOUNCE_PPS, rawB));
+    uiLastActivityMs = frameClock.ms();
   } else {
     // default: Sensitivity% with commit deadband
     if (potB_lastCommitRaw < 0) potB_lastCommitRaw = rawB;
     if (abs(rawB - potB_lastCommitRaw) >= SENS_COMMIT_RAW) {
-      int pct = constrain(map(rawB, 0, 4095, 0, 100), 0, 100);
-      GATE_SENS_Q8 = (uint8_t)((pct * 255 + 50) / 100);
       potB_lastCommitRaw = rawB;
-      uiLastActivityMs   = millis();
-      Serial.printf("Sensitivity=%d%% (Q8=%u)\n", pct, GATE_SENS_Q8);
+      uiLastActivityMs   = frameClock.ms();
+      if (paramSet(P_SENSITIVITY, paramFromKnob(P_SENSITIVITY, rawB))) paramLog(P_SENSITIVITY);
     }
   }
 }
@@ -1011,82 +1619,104 @@ if (allowB) {
 
 
 // ============== MSGEQ7 (for MUSIC_MODE only) ==============
-void readMSGEQ7() {
-
-    // ----- NEW: flush ADC channel switch noise -----
-  (void)analogRead(ANALOG_PIN);
-  delayMicroseconds(5);
-  (void)analogRead(ANALOG_PIN);
-  delayMicroseconds(5);
-
-  // Idle STROBE high before reset
-  digitalWrite(STROBE_PIN, HIGH);
-  digitalWrite(RESET_PIN,  HIGH);  delayMicroseconds(5);
-  digitalWrite(RESET_PIN,  LOW);   delayMicroseconds(5);
-
-  uint8_t newPeakN = 0;
-  bool allNearFloor = true;
-
-  for (int i = 0; i < 7; i++) {
-    // LOW time selects the band and lets it settle
-    digitalWrite(STROBE_PIN, LOW);
-    delayMicroseconds(30);
-
-    // Throw away first read after the mux step
-    (void)analogRead(ANALOG_PIN);
-    int raw = analogRead(ANALOG_PIN);
-
-    // HIGH time before next band
-    digitalWrite(STROBE_PIN, HIGH);
-    delayMicroseconds(36);
-
-    // Map ADC -> your historical scale (0..900) so we can reuse everything
-    float val900 = (float)map(raw, 0, 4095, 0, 900);
+// ADC1 has one user, adcTask (core 1, above loop()): it converts the MSGEQ7
+// output and polls both knobs (POT1 is ADC1 too). The timer tick only walks
+// RESET/STROBE; once a band has settled it asks adcTask for the sample and
+// keeps STROBE low - the chip holds its output - until the value is in.
+// The tick isn't an IRAM interrupt, so flash writes (settings save) hold it
+// off; every chip timing is a minimum, so that only stretches a frame.
+const uint8_t  POT_SAMPLES = 4;    // averaged ADC reads per knob per poll
+const uint32_t POT_POLL_MS = 10;
+
+static int averagePot(uint8_t pin) {
+  int sum = 0;
+  for (uint8_t i = 0; i < POT_SAMPLES; i++) sum += analogRead(pin);
+  return sum / POT_SAMPLES;
+}
+
+// readPot(k): knob k (0 = POT1, 1 = POT2), averaged. On the rig it's
+// adcTask's latest poll, -1 until the first one.
+#ifdef NATIVE_BUILD
+static int readPot(uint8_t k) { return averagePot(k ? POT2_PIN : POT1_PIN); }
+#else
+enum AdcRequest : uint8_t { ADC_IDLE, ADC_WANTED, ADC_DONE };
+static std::atomic<uint8_t> adcRequest{ ADC_IDLE };
+static volatile uint16_t    adcSample = 0;
+static std::atomic<int16_t> potLatest[2] = { { -1 }, { -1 } };
+static TaskHandle_t         adcTaskHandle = nullptr;
+static hw_timer_t*          msgeq7Timer = nullptr;
+
+static int readPot(uint8_t k) { return potLatest[k].load(std::memory_order_relaxed); }
+
+// Timer context: false until adcTask has latched the current band.
+bool Msgeq7Io::sample(uint16_t& out) {
+  switch (adcRequest.load(std::memory_order_acquire)) {
+    case ADC_DONE:
+      out = adcSample;
+      adcRequest.store(ADC_IDLE, std::memory_order_relaxed);
+      return true;
+    case ADC_IDLE: {
+      adcRequest.store(ADC_WANTED, std::memory_order_relaxed);
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(adcTaskHandle, &woken);
+      if (woken) portYIELD_FROM_ISR();
+      return false;
+    }
+    default:
+      return false;                                      // still converting
+  }
+}
 
-    // ----- fast envelope -----
-    bandFast[i] = bandFast[i] + EMA_FAST * (val900 - bandFast[i]);
+static void onMsgeq7Tick() { msgeq7.tick(); }
 
-    // ----- adaptive floor (tracks the "quiet" baseline) -----
-    if (bandFast[i] > bandFloor[i]) {
-      // floor creeps up very slowly toward long-term level
-      bandFloor[i] += FLOOR_UP * (bandFast[i] - bandFloor[i]);
-    } else {
-      // floor drops quickly when the scene gets quieter
-      bandFloor[i] += FLOOR_DOWN * (bandFast[i] - bandFloor[i]);
+static void adcTask(void*) {
+  uint32_t lastPotMs = millis() - POT_POLL_MS;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POT_POLL_MS));
+    if (adcRequest.load(std::memory_order_acquire) == ADC_WANTED) {
+      adcSample = (uint16_t)adc1_get_raw(ADC1_CHANNEL_0);   // GPIO36
+      adcRequest.store(ADC_DONE, std::memory_order_release);
     }
-    // keep floor sane
-    if (bandFloor[i] < 0)   bandFloor[i] = 0;
-    if (bandFloor[i] > 880) bandFloor[i] = 880;
-
-    // ----- adaptive crest (headroom tracker / slow decay) -----
-    if (bandFast[i] > bandCrest[i]) {
-      bandCrest[i] = bandFast[i];
-    } else {
-      bandCrest[i] = bandCrest[i] - CREST_DECAY * (bandCrest[i] - bandFloor[i]);
+    if (millis() - lastPotMs >= POT_POLL_MS) {
+      lastPotMs = millis();
+      potLatest[0].store((int16_t)averagePot(POT1_PIN), std::memory_order_relaxed);
+      potLatest[1].store((int16_t)averagePot(POT2_PIN), std::memory_order_relaxed);
     }
-    if (bandCrest[i] < bandFloor[i] + 10) bandCrest[i] = bandFloor[i] + 10;
+  }
+}
+#endif
 
-    // ----- normalized 0..255 loudness above floor -----
-    float f = bandFast[i] - (bandFloor[i] + FLOOR_MARGIN_900);
-    float d = (bandCrest[i] - (bandFloor[i] + FLOOR_MARGIN_900));
-    uint8_t n = 0;
-    if (d > 5.0f && f > 0.0f) {
-      float x = f / d;           // 0..1
-      x = sqrtf(x);              // compand for punchier hits
-      if (x > 1.0f) x = 1.0f;
-      n = (uint8_t)(x * 255.0f + 0.5f);
-    }
-    bandNorm[i] = n;
-    if (n > newPeakN) newPeakN = n;
+// Start background acquisition (host builds tick msgeq7 from the harness)
+void startMsgeq7() {
+#ifndef NATIVE_BUILD
+  adc1_config_width(ADC_WIDTH_BIT_12);
+  adc1_config_channel_atten(ADC1_CHANNEL_0, ADC_ATTEN_DB_11);
+  xTaskCreatePinnedToCore(adcTask, "adc", 2048, nullptr, configMAX_PRIORITIES - 2, &adcTaskHandle, 1);
+  msgeq7Timer = timerBegin(0, 80, true);                 // 1 MHz
+  timerAttachInterrupt(msgeq7Timer, &onMsgeq7Tick, true);
+  timerAlarmWrite(msgeq7Timer, MSGEQ7_TICK_US, true);
+  timerAlarmEnable(msgeq7Timer);
+#endif
+}
+
+void readMSGEQ7() {
+  // Newest complete frame from the timer engine; nothing new = keep last bands
+  Msgeq7Frame frame;
+  if (!msgeq7.latest(frame)) return;
+
+  if (recordOn) sendRawBands(frame);
+  audioPeakN = bandAnalyzer.update(frame.raw, bandNorm);
 
+  for (int i = 0; i < 7; i++) {
     // legacy smoothed bands (still helpful in a few places)
+    float val900 = (float)map(frame.raw[i], 0, 4095, 0, 900);
     smoothBands[i] = 0.7f * smoothBands[i] + 0.3f * val900;
-
-    // quiet detector (near floor)
-    if (n > 10) allNearFloor = false;
   }
 
-  audioPeakN = newPeakN;
+  // raw capture for host/sim/band_kernels.cpp
+  if (budgetReport == BR_TRACE)
+    Serial.printf("BR,%u,%u,%u,%u,%u,%u,%u\n", frame.raw[0], frame.raw[1], frame.raw[2],
+                  frame.raw[3], frame.raw[4], frame.raw[5], frame.raw[6]);
 }
 
 
@@ -1097,10 +1727,14 @@ void fx_confetti() {
   fadeToBlackBy(leds2, NUM_LEDS, CONFETTI_FADE);
 
   // slower, time-based spawning (consistent regardless of FPS)
-  EVERY_N_MILLISECONDS(CONFETTI_SPAWN_MS) {
+  static uint32_t lastSpawnMs = 0;
+  if (frameClock.ms() - lastSpawnMs >= CONFETTI_SPAWN_MS) {
+    lastSpawnMs = frameClock.ms();
+    uint16_t at[2 * CONFETTI_PER_SPAWN];           // strip 1's dots, then strip 2's
+    rngConfetti.fillIndices(at, 2 * CONFETTI_PER_SPAWN, NUM_LEDS);
     for (uint8_t i = 0; i < CONFETTI_PER_SPAWN; i++) {
-      leds1[random16(NUM_LEDS)] += CHSV(random8(), 200, 255);
-      leds2[random16(NUM_LEDS)] += CHSV(random8(), 200, 255);
+      leds1[at[i]]                      += CHSV(rngConfetti.u8(), 200, 255);
+      leds2[at[CONFETTI_PER_SPAWN + i]] += CHSV(rngConfetti.u8(), 200, 255);
     }
   }
 }
@@ -1112,22 +1746,21 @@ void fx_bounce() {
   fill_solid(leds2, NUM_LEDS, CRGB::Black);
 
   // --- Time step ---
-  uint32_t nowUs = micros();
-  uint32_t dtUs  = nowUs - bounceLastUs;
+  uint32_t dtUs  = frameClock.dtUs();
   if (dtUs > 200000) dtUs = 200000;   // clamp stalls
-  bounceLastUs = nowUs;
 
   // Speeds (px/s), with temporary jolt while active
-  uint32_t nowMs = millis();
-  int32_t v1_pps = BOUNCE_PPS + ((nowMs < joltUntilMs1) ? BOUNCE_JOLT_PPS : 0);
-  int32_t v2_pps = BOUNCE_PPS + ((nowMs < joltUntilMs2) ? BOUNCE_JOLT_PPS : 0);
+  uint32_t nowMs = frameClock.ms();
+  const Settings& fs = frameSettings();
+  int32_t v1_pps = fs.bouncePps + ((nowMs < joltUntilMs1) ? fs.bounceJoltPps : 0);
+  int32_t v2_pps = fs.bouncePps + ((nowMs < joltUntilMs2) ? fs.bounceJoltPps : 0);
 
   // 8.8 delta = v * dt
   int32_t dv1_256 = (int32_t)(( (int64_t)v1_pps * (int64_t)dtUs * 256) / 1000000LL);
   int32_t dv2_256 = (int32_t)(( (int64_t)v2_pps * (int64_t)dtUs * 256) / 1000000LL);
 
   // Travel range so the whole block stays on-strip
-  const int32_t headMax = (int32_t)(NUM_LEDS - BOUNCE_LEN) << 8;
+  const int32_t headMax = (int32_t)(NUM_LEDS - fs.bounceLen) << 8;
 
   // --- Ease profile: slower at ends, faster mid-strip ---
   auto speedProfile = [&](int32_t pos256, int32_t headMax256) -> int32_t {
@@ -1154,8 +1787,9 @@ void fx_bounce() {
   stepBounce(b2Pos256, dv2_256, b2DirRight);  // strip 2
 
   // Draw the segments using the current palette (only the block is lit)
+  const PaletteLut& lut = paletteLut();
   auto drawSegment = [&](CRGB *arr, int headIdx, bool forward, bool popPhase){
-    const int L = (int)BOUNCE_LEN;
+    const int L = (int)fs.bounceLen;
     for (int o = 0; o < L; ++o) {
       int p = forward ? (headIdx + o) : (headIdx - o);
       if (p < 0 || p >= NUM_LEDS) continue;
@@ -1168,9 +1802,9 @@ void fx_bounce() {
         w = BOUNCE_USE_SMOOTHSTEP ? (t*t)*(3.0f - 2.0f*t) : t;
       }
 
-      uint8_t palIdx = (uint8_t)((o * (256 / max(1, L - 1))) + (millis() >> 2));
+      uint8_t palIdx = (uint8_t)((o * (256 / max(1, L - 1))) + (nowMs >> 2));
       uint8_t V = scale8_video(BOUNCE_BASE_V, (uint8_t)(w * 255));
-      CRGB c = ColorFromPalette(currentPal, palIdx, V);
+      CRGB c = lut.at(palIdx, V);
       if (popPhase) { nblend(c, CRGB::White, 48); c.fadeLightBy(24); }
       arr[p] = c;
     }
@@ -1204,89 +1838,240 @@ void fx_rainbow() {
 
 
 
-// wrap distance on circular strip
-inline float wrapDistF(float a, float b, float n){
-  float d = fabsf(a - b);
-  return (d <= n - d) ? d : (n - d);
+// ---- Cloud footprint in Q8.8 pixels, built once per cloud per frame ----
+struct CloudSpan {
+  int32_t  c256;      // center
+  int32_t  half256;   // half length (mask = 0 at/after this distance)
+  int32_t  inner256;  // solid core (mask = 1 inside this distance)
+  uint32_t invRamp;   // 2^24 / (half - inner): ramp position -> Q16
+};
+
+static inline CloudSpan makeCloudSpan(const Cloud& c, float edge) {
+  CloudSpan s;
+  float halfLen = c.length * 0.5f;
+  s.c256     = (int32_t)lroundf(c.center * 256.0f);
+  s.half256  = (int32_t)lroundf(fminf(halfLen, NUM_LEDS * 0.5f) * 256.0f);  // never wraps onto itself
+  s.inner256 = (int32_t)lroundf(fmaxf(0.0f, halfLen - edge) * 256.0f);
+  int32_t ramp = max<int32_t>(1, s.half256 - s.inner256);
+  s.invRamp  = (uint32_t)((1UL << 24) / (uint32_t)ramp);
+  return s;
+}
+
+// Soft cloud mask in Q16 (65536 = inside): smoothstep shoulder between
+// inner and half, same curve as the old float softStep()
+static inline uint32_t cloudMaskQ16(int32_t d256, const CloudSpan& s) {
+  if (d256 >= s.half256)  return 0;
+  if (d256 <= s.inner256) return 65536;
+  uint32_t t  = ((uint32_t)(d256 - s.inner256) * s.invRamp) >> 8;      // 0..65535
+  uint32_t t2 = (t * t) >> 16;
+  uint32_t ss = (uint32_t)(((uint64_t)t2 * (3UL * 65536UL - 2UL * t)) >> 16);
+  return 65536 - min<uint32_t>(ss, 65536);
+}
+
+// One non-wrapping slice of a cloud: pixels [a..b], center shifted by
+// +/-NUM_LEDS when the cloud straddles the seam so distance stays |i - c|
+struct CloudPiece { int16_t a, b; int32_t c256; uint8_t k; };
+
+static inline int32_t floorDiv256(int32_t x) { return x >> 8; }               // arithmetic shift
+static inline int32_t ceilDiv256(int32_t x)  { return -((-x) >> 8); }
+
+// Split a cloud footprint (pixels with d < half) into at most 2 pieces
+static inline uint8_t cloudPieces(const CloudSpan& s, uint8_t k, CloudPiece* out) {
+  const int32_t N256 = (int32_t)NUM_LEDS << 8;
+  int32_t first = floorDiv256(s.c256 - s.half256) + 1;
+  int32_t last  = floorDiv256(s.c256 + s.half256 - 1);
+  if (last < first) return 0;
+  if (last - first >= NUM_LEDS) { first = 0; last = NUM_LEDS - 1; }   // can only touch itself
+
+  if (first < 0) {
+    out[0] = { (int16_t)(first + NUM_LEDS), (int16_t)(NUM_LEDS - 1), s.c256 + N256, k };
+    out[1] = { 0, (int16_t)last, s.c256, k };
+    return 2;
+  }
+  if (last >= NUM_LEDS) {
+    out[0] = { (int16_t)first, (int16_t)(NUM_LEDS - 1), s.c256, k };
+    out[1] = { 0, (int16_t)(last - NUM_LEDS), s.c256 - N256, k };
+    return 2;
+  }
+  out[0] = { (int16_t)first, (int16_t)last, s.c256, k };
+  return 1;
+}
+
+// Max one piece into vBuf: solid core is a straight fill, only the two
+// soft shoulders evaluate the mask
+static inline void rasterCloudPiece(uint8_t* vBuf, const CloudPiece& p, const CloudSpan& s, uint8_t baseV) {
+  int32_t coreA = max<int32_t>(p.a, ceilDiv256(p.c256 - s.inner256));
+  int32_t coreB = min<int32_t>(p.b, floorDiv256(p.c256 + s.inner256));
+  if (coreA > coreB) { coreA = p.b + 1; coreB = p.b; }   // no core: all shoulder
+
+  auto shoulder = [&](int32_t from, int32_t to) {
+    for (int32_t i = from; i <= to; i++) {
+      if (vBuf[i] == baseV) continue;                   // already full from another cloud
+      uint32_t w = cloudMaskQ16(abs((i << 8) - p.c256), s);
+      uint8_t V = (uint8_t)(((uint32_t)baseV * w) >> 16);
+      if (V > vBuf[i]) vBuf[i] = V;
+    }
+  };
+  shoulder(p.a, min<int32_t>(p.b, coreA - 1));
+  if (coreA <= coreB) memset(vBuf + coreA, baseV, coreB - coreA + 1);
+  shoulder(max<int32_t>(p.a, coreB + 1), p.b);
 }
 
-// smooth edge (0 outside → 1 inside) with soft shoulders
-inline float softStep(float x, float halfLen, float edge){
-  // x = distance from center
-  float inner = fmaxf(0.0f, halfLen - edge);
-  if (x >= halfLen) return 0.0f;
-  if (x <= inner)   return 1.0f;
-  // between inner..halfLen, apply smoothstep falloff
-  float t = (x - inner) / fmaxf(1e-6f, (halfLen - inner));
-  // smootherstep
-  return 1.0f - (t*t*(3.0f - 2.0f*t));
+// sin8 is called 3x per lit pixel; a 256-byte table is cheaper on the ESP32
+static uint8_t SIN8_LUT[256];
+static bool    sin8LutReady = false;
+static inline void initSin8Lut() {
+  for (int i = 0; i < 256; i++) SIN8_LUT[i] = sin8((uint8_t)i);
+  sin8LutReady = true;
 }
 
-// advance + render a palette as clouds to one strip
-void renderPaletteClouds(CRGB* led, bool reverseIndex,
-                         const CRGBPalette16& pal, uint8_t baseV, Cloud* C,
-                         uint16_t t1, uint16_t t2, uint16_t t3)
-{
-  // time step for cloud centers (kept)
-  uint32_t nowUs = micros();
-  static uint32_t lastUs = nowUs;
-  uint32_t dtUs  = nowUs - lastUs;
-  if (dtUs > 300000) dtUs = 300000;
-  float dt = dtUs / 1000000.0f;
-
-  // animate clouds (kept)
+void CloudField::init(float baseSpeed, FxRng& rng) {
   for (uint8_t i=0;i<CLOUD_COUNT;i++){
-    C[i].center += C[i].speed * dt;
-    while (C[i].center < 0)          C[i].center += NUM_LEDS;
-    while (C[i].center >= NUM_LEDS)  C[i].center -= NUM_LEDS;
+    c[i].center = rng.u16(NUM_LEDS);
+    c[i].length = (float)rng.range((int32_t)CLOUD_MIN_LEN, (int32_t)CLOUD_MAX_LEN);
+    c[i].speed  = baseSpeed * (0.7f + (rng.u8()/255.0f)*0.6f); // ±30% variation
+    c[i].wobble = rng.u16(); // random phase
+  }
+}
+
+static void seedEffects(uint32_t seed) {
+  fxSeed = seed;
+  rngClouds.setSeed(FxRng::streamSeed(seed, RNG_CLOUDS));
+  rngConfetti.setSeed(FxRng::streamSeed(seed, RNG_CONFETTI));
+  rngSparkle.setSeed(FxRng::streamSeed(seed, RNG_SPARKLE));
+  rngFlicker.setSeed(FxRng::streamSeed(seed, RNG_FLICKER));
+  clouds1.init(CLOUD_SPEED_1, rngClouds);
+  clouds2.init(CLOUD_SPEED_2, rngClouds);
+}
 
-    float breath = 1.0f + CLOUD_BREATHE * sinf( (millis()*0.0015f) + (C[i].wobble*0.0003f) );
-    C[i].length = fminf(CLOUD_MAX_LEN, fmaxf(CLOUD_MIN_LEN, C[i].length * breath));
+// dt in seconds; speedScale multiplies every cloud's speed for this step
+void CloudField::advance(float dt, float speedScale, uint32_t nowMs) {
+  // the breath factor is per 1/60 s, applied as dt's share of it and
+  // sampled mid-step, so lengths track the same curve at any frame rate
+  const float breathSteps = dt * 60.0f;
+  const float breathMs    = nowMs - dt * 500.0f;
+  for (uint8_t i=0;i<CLOUD_COUNT;i++){
+    c[i].center += c[i].speed * speedScale * dt;
+    while (c[i].center < 0)          c[i].center += NUM_LEDS;
+    while (c[i].center >= NUM_LEDS)  c[i].center -= NUM_LEDS;
+
+    float breath = 1.0f + CLOUD_BREATHE * sinf( (breathMs*0.0015f) + (c[i].wobble*0.0003f) );
+    c[i].length = fminf(CLOUD_MAX_LEN, fmaxf(CLOUD_MIN_LEN, c[i].length * powf(breath, breathSteps)));
   }
-  lastUs = nowUs;
+}
+
+// render the clouds where they are now, as palette colors, to one strip
+void CloudField::render(CRGB* led, bool reverseIndex, const PaletteLut& pal, uint8_t baseV,
+                        uint16_t t1, uint16_t t2, uint16_t t3)
+{
+  if (!sin8LutReady) initSin8Lut();
+  const Settings& fs = frameSettings();
 
-  // black baseline
-  fill_solid(led, NUM_LEDS, CRGB::Black);
+  // each cloud's fixed-point span
+  CloudSpan span[CLOUD_COUNT];
+  for (uint8_t i=0;i<CLOUD_COUNT;i++) span[i] = makeCloudSpan(c[i], fs.cloudEdge);
+
+  // slice clouds into non-wrapping pieces, sorted by start pixel
+  CloudPiece pieces[CLOUD_COUNT * 2];
+  uint8_t nPieces = 0;
+  for (uint8_t k=0;k<quality.clouds;k++) nPieces += cloudPieces(span[k], k, pieces + nPieces);
+  for (uint8_t i=1;i<nPieces;i++){                        // insertion sort, <= 2*CLOUD_COUNT
+    CloudPiece p = pieces[i];
+    int8_t j = i - 1;
+    while (j >= 0 && pieces[j].a > p.a) { pieces[j+1] = pieces[j]; j--; }
+    pieces[j+1] = p;
+  }
 
   // use caller-provided phases to build color index (this is the “flow”)
-  for (int i=0;i<NUM_LEDS;i++){
-    uint8_t idx1 = sin8(i * 2 + (t1 >> 2));
-    uint8_t idx2 = sin8(i * 3 + (t2 >> 3));
-    uint8_t idx3 = sin8(i * 1 + (t3 >> 4));
-    uint8_t colorIndex = (idx1/3) + (idx2/3) + (idx3/3);
-
-    // soft cloud masks
-    float m = 0.0f;
-    for (uint8_t k=0;k<CLOUD_COUNT;k++){
-      float d = wrapDistF((float)i, C[k].center, (float)NUM_LEDS);
-      float halfLen = C[k].length * 0.5f;
-      float w = softStep(d, halfLen, CLOUD_EDGE);
-      if (w > m) m = w;
+  const uint8_t ph1 = (uint8_t)(t1 >> 2), ph2 = (uint8_t)(t2 >> 3), ph3 = (uint8_t)(t3 >> 4);
+  auto put = [&](int i, const CRGB& c){ led[ reverseIndex ? (NUM_LEDS-1-i) : i ] = c; };
+  auto putBlack = [&](int from, int to){       // [from..to] in strip-1 order
+    if (from > to) return;
+    if (reverseIndex) fill_solid(led + (NUM_LEDS-1-to), to - from + 1, CRGB::Black);
+    else              fill_solid(led + from,            to - from + 1, CRGB::Black);
+  };
+
+  // sweep the union of pieces: gaps go black, covered runs get masked + colored
+  uint8_t* vBuf = vBuf_;
+  int gapStart = 0;
+  uint8_t p = 0;
+  while (p < nPieces) {
+    int runA = pieces[p].a, runB = pieces[p].b;
+    uint8_t q = p + 1;
+    while (q < nPieces && pieces[q].a <= runB + 1) { runB = max<int>(runB, pieces[q].b); q++; }
+
+    putBlack(gapStart, runA - 1);
+    memset(vBuf + runA, 0, runB - runA + 1);
+    for (uint8_t r = p; r < q; r++) rasterCloudPiece(vBuf, pieces[r], span[pieces[r].k], baseV);
+
+    for (int i = runA; i <= runB; i++) {
+      uint8_t V = vBuf[i];
+      if (!V) { put(i, CRGB::Black); continue; }
+      uint8_t idx1 = SIN8_LUT[(uint8_t)(i * 2 + ph1)];
+      uint8_t idx2 = SIN8_LUT[(uint8_t)(i * 3 + ph2)];
+      uint8_t idx3 = SIN8_LUT[(uint8_t)(i * 1 + ph3)];
+      uint8_t colorIndex = (idx1/3) + (idx2/3) + (idx3/3);
+      uint8_t ci = reverseIndex ? (colorIndex + 64) : colorIndex;
+      put(i, pal.at(ci, V));
     }
-    if (m <= 0.001f) continue;
+    gapStart = runB + 1;
+    p = q;
+  }
+  putBlack(gapStart, NUM_LEDS - 1);
+}
+
+// ---- Both strips' clouds, one strip per core (stripFork) ----
+// Everything the halves read is fixed before the fork (call paletteLut()
+// first, it rebuilds lazily); each half writes only its strip and CloudField.
+// Every field goes through the constructor, so a new one can't be left
+// silently zeroed by an aggregate init.
+struct CloudsJob {
+  CloudsJob(const PaletteLut& pal_, uint8_t baseV_, float speedScale_, float dt_, uint32_t nowMs_,
+            const uint16_t (&t1)[3], const uint16_t (&t2)[3])
+      : pal(&pal_), baseV(baseV_), speedScale(speedScale_), dt(dt_), nowMs(nowMs_) {
+    memcpy(t[0], t1, sizeof(t[0]));
+    memcpy(t[1], t2, sizeof(t[1]));
+  }
+
+  const PaletteLut* pal;
+  uint8_t  baseV;
+  float    speedScale;
+  float    dt;               // s, cloudsDt()
+  uint32_t nowMs;
+  uint16_t t[2][3];          // flow phases per strip
+};
 
-    uint8_t V = (uint8_t)constrain((int)(baseV * m), 0, 255);
-    uint8_t ci = reverseIndex ? (colorIndex + 64) : colorIndex;
-    led[ reverseIndex ? (NUM_LEDS-1-i) : i ] = ColorFromPalette(pal, ci, V);
-  }
+// This frame's step for cloud motion, a stall capped at 0.3 s.
+static float cloudsDt() { return min<uint32_t>(frameClock.dtUs(), 300000) / 1000000.0f; }
+
+static void cloudsJobStrip(void* ctx, uint8_t s) {
+  const CloudsJob& j = *(const CloudsJob*)ctx;
+  CloudField& f = s ? clouds2 : clouds1;
+  f.advance(j.dt, j.speedScale, j.nowMs);
+  f.render(s ? leds2 : leds1, s == 1, *j.pal, j.baseV, j.t[s][0], j.t[s][1], j.t[s][2]);
+}
+
+// One frame's timestep for both fields, capped so a stall doesn't jump.
+static void renderCloudsPair(const CloudsJob& j) {
+  stripFork.run(cloudsJobStrip, (void*)&j);
 }
 
 
 // ============== Palette blending render (MUSIC_MODE) ==============
 void fx_paletteFlow() {
+  const Settings& fs = frameSettings();
 
   // normalized, sensitivity-adjusted bands
   uint8_t bassN   = sens(bandNorm[1]);
   uint8_t midN    = sens(bandNorm[3]);
   uint8_t trebleN = sens(bandNorm[5]);
-  uint8_t peakN   = sens(audioPeakN);
 
   // Gates (normalized) — compute ONCE
-  const uint8_t BASS_GATE_N   = gateToNorm255(BASS_GATE_THRESH);
-  const uint8_t TREBLE_GATE_N = gateToNorm255(TREBLE_GATE_THRESH);
+  const uint8_t BASS_GATE_N   = gateToNorm255(fs.bassGate);
+  const uint8_t TREBLE_GATE_N = gateToNorm255(fs.trebleGate);
 
   auto can_hit = [](unsigned long lastMs, uint16_t debounce)->bool{
-    return (millis() - lastMs) > debounce;
+    return (frameClock.ms() - lastMs) > debounce;
   };
 
     // === NEW: palette phase state (per-strip), plus music-reactive increments ===
@@ -1319,34 +2104,22 @@ void fx_paletteFlow() {
   T1a += inc1a;  T2a += inc2a;  T3a += inc3a;
   T1b -= inc1b;  T2b -= inc2b;  T3b -= inc3b;
 
-// ----- Unified LASER auto strobe gate (all palettes) -----
-if (LASER_AUTO_ENABLED) {
-  unsigned long now = millis();
-  if (normTo900(peakN) >= LASER_GATE_THRESH) {
-    if (!laserStrobeActive && (now - lastLaserTrigger > LASER_DEBOUNCE_MS)) {
-      laserStrobeActive = true;
-      laserStrobeStart  = now;
-      lastLaserTrigger  = now;
-    }
-  }
-}
-
   // ============== DARK palette =========
-  if (musicPaletteIndex == DARK_PALETTE_INDEX) {
+  if (fs.palette == DARK_PALETTE_INDEX) {
     fill_solid(leds1, NUM_LEDS, CRGB::Black);
     fill_solid(leds2, NUM_LEDS, CRGB::Black);
 
-    unsigned long nowMs = millis();
+    unsigned long nowMs = frameClock.ms();
 
     // Energy-scaled pops (brightness + length)
-    if (bassN >= BASS_GATE_N && can_hit(lastBassHitMs, BASS_HIT_DEBOUNCE)) {
+    if (bassN >= BASS_GATE_N && can_hit(lastBassHitMs, fs.bassHitMs)) {
       uint8_t vMax = hitV_u8(bassN, BASS_GATE_N);
       int     len  = scaledLen_u8(bassN, BASS_GATE_N, BASS_SEG_LEN, 32);
       spawnSegmentStrong(musicBassCursor, len, true, vMax);
       musicBassCursor = (musicBassCursor + BASS_STEP) % NUM_LEDS;
       lastBassHitMs = nowMs;
     }
-    if (trebleN >= TREBLE_GATE_N && can_hit(lastTrebleHitMs, TREB_HIT_DEBOUNCE)) {
+    if (trebleN >= TREBLE_GATE_N && can_hit(lastTrebleHitMs, fs.trebHitMs)) {
       uint8_t vMax = hitV_u8(trebleN, TREBLE_GATE_N);
       int     len  = scaledLen_u8(trebleN, TREBLE_GATE_N, TREB_SEG_LEN, 18);
       spawnSegmentStrong(musicTrebleCursor - len + 1, len, false, vMax);
@@ -1359,38 +2132,35 @@ if (LASER_AUTO_ENABLED) {
   }
 
   // -------- CLOUD / BLOCK RENDERING (non-Dark) ----------
+const PaletteLut& palLut = paletteLut();
 float curved = powf(constrain(g_sceneLevel, 0.f, 1.f), 0.8f);
 uint8_t bright = (uint8_t)(18 + (210 - 18) * curved);
 float motion = 0.6f + 1.0f * g_sceneLevel;
-motion *= (CLOUD_SPEED_SCALE / 100.0f);
+motion *= (fs.cloudSpeedScale / 100.0f);
   
-  float s1[CLOUD_COUNT], s2[CLOUD_COUNT];
-  for (uint8_t i=0;i<CLOUD_COUNT;i++){ s1[i]=clouds1[i].speed; s2[i]=clouds2[i].speed;
-                                       clouds1[i].speed*=motion;  clouds2[i].speed*=motion; }
-renderPaletteClouds(leds1, false, currentPal, bright, clouds1, T1a, T2a, T3a);
-renderPaletteClouds(leds2, true,  currentPal, bright, clouds2, T1b, T2b, T3b);
-  for (uint8_t i=0;i<CLOUD_COUNT;i++){ clouds1[i].speed=s1[i]; clouds2[i].speed=s2[i]; }
+  const CloudsJob clouds(palLut, bright, motion, cloudsDt(), frameClock.ms(), { T1a, T2a, T3a }, { T1b, T2b, T3b });
+  renderCloudsPair(clouds);      // barrier: both strips done before anything below
 
   // Subtle shimmer
   uint8_t warpAmt = (uint8_t)(10 + 40 * g_sceneLevel);
   if (warpAmt > 0) {
-    uint32_t t = millis();
-    for (int i=0;i<NUM_LEDS;i++){
-      if ((i + t/20) % 40 == 0) {
-        uint8_t idx = (i*2 + (t>>4)) & 0xFF;
-        CRGB w = ColorFromPalette(currentPal, idx, warpAmt);
-        nblend(leds1[i], w, warpAmt);
-        nblend(leds2[NUM_LEDS-1-i], w, warpAmt);
-      }
+    uint32_t t = frameClock.ms();
+    const uint8_t every = quality.shimmerSpacing;
+    // pixels with (i + t/20) % every == 0
+    for (int i = (every - (int)((t/20) % every)) % every; i < NUM_LEDS; i += every){
+      uint8_t idx = (i*2 + (t>>4)) & 0xFF;
+      CRGB w = palLut.at(idx, warpAmt);
+      nblend(leds1[i], w, warpAmt);
+      nblend(leds2[NUM_LEDS-1-i], w, warpAmt);
     }
   }
 
   // Treble sparkles (kept)
   int trebleVal = normTo900(trebleN);
-  uint8_t sparkleCeil = (uint8_t)(12 * SPARKLE_INTENSITY / 100);
+  uint8_t sparkleCeil = (uint8_t)(12 * fs.sparkleIntensity / 100);
   uint8_t sparkleProb = (uint8_t)constrain(map(trebleVal, 200, 900, 0, sparkleCeil), 0, sparkleCeil);
-  if (sparkleProb > 0 && random8() < sparkleProb) {
-    int p = random16(NUM_LEDS);
+  if (sparkleProb > 0 && rngSparkle.u8() < sparkleProb) {
+    int p = rngSparkle.u16(NUM_LEDS);
     CRGB sp = CRGB::White; sp.fadeLightBy(200);
     nblend(leds1[p], sp, 96);
     nblend(leds2[NUM_LEDS-1-p], sp, 96);
@@ -1404,15 +2174,15 @@ renderPaletteClouds(leds2, true,  currentPal, bright, clouds2, T1b, T2b, T3b);
   }
 
   // ----------------- POP SEGMENTS (non-Dark) ----------------------
-  unsigned long nowMs2 = millis();
-  if (bassN >= BASS_GATE_N && can_hit(lastBassHitMs, BASS_HIT_DEBOUNCE)) {
+  unsigned long nowMs2 = frameClock.ms();
+  if (bassN >= BASS_GATE_N && can_hit(lastBassHitMs, fs.bassHitMs)) {
     uint8_t vMax = hitV_u8(bassN, BASS_GATE_N);
     int     len  = scaledLen_u8(bassN, BASS_GATE_N, BASS_SEG_LEN, 28);
     spawnSegmentStrong(musicBassCursor, len, true, vMax);
     musicBassCursor = (musicBassCursor + BASS_STEP) % NUM_LEDS;
     lastBassHitMs = nowMs2;
   }
-  if (trebleN >= TREBLE_GATE_N && can_hit(lastTrebleHitMs, TREB_HIT_DEBOUNCE)) {
+  if (trebleN >= TREBLE_GATE_N && can_hit(lastTrebleHitMs, fs.trebHitMs)) {
     uint8_t vMax = hitV_u8(trebleN, TREBLE_GATE_N);
     int     len  = scaledLen_u8(trebleN, TREBLE_GATE_N, TREB_SEG_LEN, 16);
     spawnSegmentStrong(musicTrebleCursor - len + 1, len, false, vMax);
@@ -1423,149 +2193,136 @@ renderPaletteClouds(leds2, true,  currentPal, bright, clouds2, T1b, T2b, T3b);
 }
 
 
-void addSegmentOverlay() {
-  // No flicker needed; pops are deterministic and punchy
-  unsigned long now = millis();
-
-  for (uint8_t s = 0; s < MAX_SEGMENTS; s++) {
-    if (!segments[s].active) continue;
-
-    uint32_t age = now - segments[s].startMs;
-    if (age > (POP_FLASH_MS + POP_HOLD_MS + POP_FADE_MS)) {
-      segments[s].active = false;
-      continue;
-    }
-
-    // Choose accent per palette & type
-    const CRGB accent = segments[s].bass ? ACCENT[musicPaletteIndex].bass
-                                     : ACCENT[musicPaletteIndex].treble;
-
-// phases:
-bool flashPhase = age < POP_FLASH_MS_K;
-bool holdPhase  = (!flashPhase) && (age < POP_FLASH_MS_K + POP_HOLD_MS_K);
-bool fadePhase  = (!flashPhase && !holdPhase);
-
-// fade amount:
-uint8_t fadeV = 255;
-if (fadePhase) {
-  uint16_t fAge = (uint16_t)min<uint32_t>(age - (POP_FLASH_MS_K + POP_HOLD_MS_K), POP_FADE_MS_K);
-  fadeV = 255 - map((long)fAge, 0L, (long)POP_FADE_MS_K, 0L, 255L);
+// Dark hits texture the palette index with a 5-bit jitter: (p * 7) & 31
+// stepped by age. Indexed by p & 31 (the pattern repeats every 32 px).
+static uint8_t DARK_JITTER[32];
+static bool    darkJitterReady = false;
+static inline void initDarkJitter() {
+  for (uint8_t i = 0; i < 32; i++) DARK_JITTER[i] = (uint8_t)((i * 7) & 0x1F);
+  darkJitterReady = true;
 }
 
+// Pop envelope for one segment this frame (was re-evaluated per pixel)
+struct SegEnvelope {
+  bool    flash;       // white push instead of a scale
+  bool    overwrite;   // flash/hold write straight through, fade blends 200
+  uint8_t whiteAmt;    // flash: blend toward white
+  uint8_t scale;       // hold/fade: nscale8_video amount
+};
 
-
-    // Segment bounds
-    // --- replace the inner loop from "int segLen = ..." down to the writes ---
-int segLen = max(0, segments[s].length);
-
-// precompute lane bias & dark flag once
-uint8_t laneBias = segments[s].bass ? 24 : 160;
-bool darkSelected = (musicPaletteIndex == DARK_PALETTE_INDEX);
-
-for (int o = 0; o < segLen; o++) {
-  int p1 = (segments[s].start + o) % NUM_LEDS;
-  int p2 = (NUM_LEDS - 1) - p1;
-
-  // texture/jitter drives palette index
-  uint8_t jitter = ((p1 * 7) + (age >> 2)) & 0x1F;
-  uint8_t palIdx1 = ((p1 * 2) + laneBias + jitter) & 0xFF;
-  uint8_t palIdx2 = ((p2 * 2) + laneBias + jitter) & 0xFF; // separate index for strip2
-
-  // base colors: in Dark, choose by HIT TYPE (bass vs treble), not by strip
-CRGB base1, base2;
-if (darkSelected) {
-  const CRGBPalette16& hitPal = segments[s].bass ? PALETTE_DARK_BASS
-                                                 : PALETTE_DARK_TREBLE;
-  // same color on both strips (mirrored)
-  CRGB base = ColorFromPalette(hitPal, palIdx1, 255);
-  base1 = base;
-  base2 = base;
-} else {
-  const CRGB accent = segments[s].bass ? ACCENT[musicPaletteIndex].bass
-                                       : ACCENT[musicPaletteIndex].treble;
-  base1 = base2 = accent;
+static inline SegEnvelope segEnvelope(uint32_t age, uint8_t vMax) {
+  SegEnvelope e;
+  bool flashPhase = age < POP_FLASH_MS;
+  bool holdPhase  = (!flashPhase) && (age < POP_FLASH_MS + POP_HOLD_MS);
+  e.flash     = flashPhase;
+  e.overwrite = flashPhase || holdPhase;
+  e.whiteAmt  = flashPhase ? scale8_video(200, vMax) : 0;   // big hits = whiter flash
+  if (flashPhase)     e.scale = 255;
+  else if (holdPhase) e.scale = vMax;                       // hold at per-hit max
+  else {                                                    // fade down from per-hit max
+    uint16_t fAge = (uint16_t)min<uint32_t>(age - (POP_FLASH_MS + POP_HOLD_MS), POP_FADE_MS);
+    uint8_t fadeV = 255 - map((long)fAge, 0L, (long)POP_FADE_MS, 0L, 255L);
+    e.scale = scale8_video(fadeV, vMax);
+  }
+  return e;
+}
+
+static inline CRGB applySegEnvelope(CRGB c, const SegEnvelope& e) {
+  if (e.flash) nblend(c, CRGB::White, e.whiteAmt);
+  else       c.nscale8_video(e.scale);
+  return c;
 }
 
-
-
-  // apply the pop envelope
-  uint8_t vMax = segments[s].vMax;               // 180..255 per hit
-uint8_t fadeScaled = scale8_video(fadeV, vMax); // fade shaped by max
-
-auto applyEnvelope = [&](CRGB c)->CRGB {
-  if (flashPhase) {
-    // White push also scales with vMax (big hits = whiter flash)
-    uint8_t whiteAmt = scale8_video(200, vMax); // up to ~200
-    nblend(c, CRGB::White, whiteAmt);
-    return c;
-  }
-  if (holdPhase) {
-    c.nscale8_video(vMax); // hold at per-hit max
-    return c;
+// Write one run [a..b] of strip-1 pixels (strip 2 mirrored: N-1-p)
+static inline void writeSegRun(int a, int b, const CRGB& c, bool overwrite) {
+  if (a > b) return;
+  int n = b - a + 1;
+  if (overwrite) {
+    fill_solid(leds1 + a, n, c);
+    fill_solid(leds2 + (NUM_LEDS - 1 - b), n, c);
+  } else {
+    for (int p = a; p <= b; p++) {
+      nblend(leds1[p], c, 200);
+      nblend(leds2[NUM_LEDS - 1 - p], c, 200);
+    }
   }
-  c.nscale8_video(fadeScaled); // fade down from per-hit max
-  return c;
-};
+}
 
+static inline void writeSegPixel(int p, const CRGB& c, bool overwrite) {
+  if (overwrite) { leds1[p] = c; leds2[NUM_LEDS - 1 - p] = c; }
+  else { nblend(leds1[p], c, 200); nblend(leds2[NUM_LEDS - 1 - p], c, 200); }
+}
 
-  CRGB pop1 = applyEnvelope(base1);
-  CRGB pop2 = applyEnvelope(base2);
+void addSegmentOverlay() {
+  // No flicker needed; pops are deterministic and punchy
+  unsigned long now = frameClock.ms();
+  if (!darkJitterReady) initDarkJitter();
+  const Settings& fs = frameSettings();
+  const bool darkSelected = (fs.palette == DARK_PALETTE_INDEX);
+
+  for (uint8_t s = segments.first(), nx; s != segments.NIL; s = nx) {
+    nx = segments.next(s);
+    const Segment& seg = segments[s];
+
+    uint32_t age = now - seg.startMs;
+    if (age > POP_TOTAL_MS) {                    // same constants as segEnvelope()
+      segments.release(s);
+      continue;
+    }
 
-  // optional white edge tips
-  if (POP_EDGE_WHITE && (flashPhase || holdPhase) && (o == 0 || o == segLen - 1)) {
-    pop1 = CRGB::White;
-    pop2 = CRGB::White;
-  }
+    int segLen = min(max(0, seg.length), NUM_LEDS);
+    if (!segLen) continue;
+    const SegEnvelope env = segEnvelope(age, seg.vMax);
+
+    // at most two runs of strip-1 pixels, split at the wrap
+    const int a0 = seg.start;
+    const int end = a0 + segLen - 1;                     // may run past the end
+    const int b0 = min(end, NUM_LEDS - 1);
+    const int b1 = end - NUM_LEDS;                       // second run [0..b1] if >= 0
+    const int tipA = a0, tipB = (end >= NUM_LEDS) ? b1 : end;
+    const bool tips = POP_EDGE_WHITE && env.overwrite;
+
+    if (!darkSelected) {
+      // accent is flat across the segment: one color per frame
+      const CRGB accent = seg.bass ? ACCENT[fs.palette].bass
+                                   : ACCENT[fs.palette].treble;
+      const CRGB pop = applySegEnvelope(accent, env);
+      writeSegRun(a0, b0, pop, env.overwrite);
+      writeSegRun(0, b1, pop, env.overwrite);
+    } else {
+      // Dark: palette by HIT TYPE (bass vs treble), same color on both strips
+      const PaletteLut& hitPal = seg.bass ? darkBassLut : darkTrebleLut;
+      const uint8_t laneBias = seg.bass ? 24 : 160;
+      const uint8_t ageJit = (uint8_t)(age >> 2);
+      auto run = [&](int a, int b) {
+        for (int p = a; p <= b; p++) {
+          uint8_t jitter = (DARK_JITTER[p & 0x1F] + ageJit) & 0x1F;
+          uint8_t palIdx = (uint8_t)(p * 2 + laneBias + jitter);
+          writeSegPixel(p, applySegEnvelope(hitPal.e[palIdx], env), env.overwrite);
+        }
+      };
+      run(a0, b0);
+      run(0, b1);
+    }
 
-  // write: overwrite on flash/hold; blend on fade
-  if (flashPhase || holdPhase) {
-    leds1[p1] = pop1;
-    leds2[p2] = pop2;
-  } else {
-    nblend(leds1[p1], pop1, 200);
-    nblend(leds2[p2], pop2, 200);
-  }
-}
+    // optional white edge tips
+    if (tips) {
+      writeSegPixel(tipA, CRGB::White, true);
+      writeSegPixel(tipB, CRGB::White, true);
+    }
   }
 }
 
 
 void spawnSegment(int start, int len, bool isBass) {
-  int normStart = (start % NUM_LEDS + NUM_LEDS) % NUM_LEDS;
-
-  for (uint8_t s = 0; s < MAX_SEGMENTS; s++) {
-    if (!segments[s].active) {
-      segments[s] = { normStart, len, millis(), isBass, true, /*vMax*/ 220 };
-      return;
-    }
-  }
-  uint8_t oldest = 0; unsigned long oldestAge = 0; unsigned long now = millis();
-  for (uint8_t s = 0; s < MAX_SEGMENTS; s++) {
-    unsigned long age = now - segments[s].startMs;
-    if (age > oldestAge) { oldestAge = age; oldest = s; }
-  }
-  segments[oldest] = { normStart, len, now, isBass, true, /*vMax*/ 220 };
+  spawnSegmentStrong(start, len, isBass, /*vMax*/ 220);
 }
 
 
-// NEW helper: strength-aware spawn
+// NEW helper: strength-aware spawn (free slot, else overwrite the oldest)
 void spawnSegmentStrong(int start, int len, bool isBass, uint8_t vMax) {
   int normStart = (start % NUM_LEDS + NUM_LEDS) % NUM_LEDS;
-
-  // try free slot first
-  for (uint8_t s = 0; s < MAX_SEGMENTS; s++) {
-    if (!segments[s].active) {
-      segments[s] = { normStart, len, millis(), isBass, true, vMax };
-      return;
-    }
-  }
-  // overwrite the oldest
-  uint8_t oldest = 0; unsigned long oldestAge = 0, now = millis();
-  for (uint8_t s = 0; s < MAX_SEGMENTS; s++) {
-    unsigned long age = now - segments[s].startMs;
-    if (age > oldestAge) { oldestAge = age; oldest = s; }
-  }
-  segments[oldest] = { normStart, len, now, isBass, true, vMax };
+  segments[segments.spawn()] = { normStart, len, frameClock.ms(), isBass, vMax };
 }
 
 
@@ -1575,8 +2332,8 @@ void fx_segmentDJ() {
   u1 -= 1; u2 -= 2; u3 -= 3;     // strip 2 slow reverse
 
   const uint8_t baseV = BRIGHTNESS;
-  renderPaletteClouds(leds1, /*reverseIndex=*/false, currentPal, baseV, clouds1, t1, t2, t3);
-  renderPaletteClouds(leds2, /*reverseIndex=*/true,  currentPal, baseV, clouds2, u1, u2, u3);
+  const CloudsJob clouds(paletteLut(), baseV, 1.0f, cloudsDt(), frameClock.ms(), { t1, t2, t3 }, { u1, u2, u3 });
+  renderCloudsPair(clouds);
 
   addSegmentOverlay();
 }
@@ -1592,193 +2349,279 @@ void setMusicPalette(uint8_t idx, uint16_t ms, bool instant) {
   if (idx >= MUSIC_PALETTE_COUNT) return;
 
   targetPal         = musicPalettes[idx];
-  musicPaletteIndex = idx;
+  settings.palette = idx;
 
   // Hard-cut the "Dark" palette (or when requested)
   if (instant || ms == 0 || idx == DARK_PALETTE_INDEX) {
     palBlendMs   = 0;
-    currentPal   = targetPal;
+    settlePalette();
   } else {
-    palBlendMs   = ms;
-    palBlendLast = millis();   // start timing from now
-  }
+    palBlendFrom    = currentPal;  // fade from wherever we are now
+    palBlendMs      = ms;
+    palBlendStartMs = frameClock.ms();
+    palConverged    = palettesEqual(currentPal, targetPal);
+  }
+
+  Serial.print("Palette -> "); Serial.println(musicPaletteNames[settings.palette]);
+  invalidateHud();
+}
+
+
+
+
+// ============== INPUT ==============
+// Serial keys, buttons, knobs and touch pads never touch render state where
+// they're read. pollInputs() (producer) reads the hardware, decodes keys and
+// debounces, and pushes typed InputCmds onto an SPSC queue; applyInputs()
+// (consumer) pops them at the top of the frame and applies them all before
+// anything renders, so a frame never sees half an input. The producer owns
+// nothing but its decoder/debounce state and could move to a task as is.
+// It doesn't sample the knobs itself: ADC1 belongs to adcTask (see MSGEQ7),
+// and readPot() returns its latest poll.
+enum InputOp : uint8_t {
+  IN_NONE,              // key with no action of its own (still ends a blackout)
+  IN_ARROW,             // arg: 'A' up, 'B' down, 'C' right, 'D' left
+  IN_ARROW_TARGET,      // next gate for Up/Down
+  IN_AUTO_CYCLE,
+  IN_DUMP_IO,
+  IN_BLACKOUT,
+  IN_STROBE_KEY,
+  IN_PALETTE,           // arg: palette index
+  IN_BUDGET_REPORT,
+  IN_TARGET_FPS,        // value: FPS delta
+  IN_TELEMETRY,
+  IN_PRINT_BANDS,
+  IN_RECORD,
+  IN_EFFECT,            // arg: FX index
+  IN_TAP,               // DJ tap, arg: 0 bass / 1 treble; outside DJ steps the effect by value
+  IN_STEP_EFFECT,       // value: +1 / -1
+  IN_FLASH_PULSE,
+  IN_JOLT,
+  IN_TO_MUSIC,
+  IN_PARAM_STEP,        // arg: ParamId, value: -1 / +1 steps
+  IN_LASER_TOGGLE,
+  IN_RESTORE_DEFAULTS,
+  IN_BUTTON,            // arg: BI_*, value: pressed
+  IN_POT,               // arg: 0 left / 1 right, value: raw 0..4095
+  IN_TOUCH,             // arg: 0 strobe pad / 1 flash pad, value: held
+  IN_OP_COUNT
+};
+const uint8_t INF_WAKES = 0x01;   // serial key: ends a blackout before it applies
 
-  Serial.print("Palette -> "); Serial.println(musicPaletteNames[musicPaletteIndex]);
-  drawHome();
-}
+struct InputCmd {
+  uint8_t op;
+  uint8_t arg;
+  uint8_t flags;
+  int16_t value;
+};
 
+static SpscQueue<InputCmd, 64> inputQueue;
+const  int     POT_MOVE_RAW = 8;   // smaller moves aren't queued
+
+// ---- producer ----
+// One serial byte -> at most one command. False while inside an ESC sequence.
+static bool decodeKey(char c, InputCmd& out) {
+  out = { IN_NONE, 0, INF_WAKES, 0 };
+
+  // Arrow keys: ESC [ A/B/C/D; anything else aborts and is decoded as itself
+  if (escState == ESC_SEEN) {
+    escState = ESC_IDLE;
+    if (c == '[') { escState = ESC_BRACKET; return false; }
+  } else if (escState == ESC_BRACKET) {
+    escState = ESC_IDLE;
+    if (c >= 'A' && c <= 'D') { out = { IN_ARROW, (uint8_t)c, 0, 0 }; return true; }
+  }
+  if ((uint8_t)c == 0x1B) { escState = ESC_SEEN; return false; }
+
+  // these three leave a blackout alone
+  if (c == 'a' || c == 'A') { out = { IN_AUTO_CYCLE, 0, 0, 0 }; return true; }
+  if (c == 'Z')             { out = { IN_DUMP_IO,    0, 0, 0 }; return true; }
+  if (c == 'd')             { out = { IN_BLACKOUT,   0, 0, 0 }; return true; }
+
+  switch (c) {
+    case 's': case 'S': out.op = IN_STROBE_KEY; break;
+    case 'u': case 'U': out.op = IN_BUDGET_REPORT; break;
+    case '+':           out.op = IN_TARGET_FPS; out.value = +5; break;
+    case '-':           out.op = IN_TARGET_FPS; out.value = -5; break;
+    case 'g':           out.op = IN_TELEMETRY; break;
+    case 'G':           out.op = IN_PRINT_BANDS; break;
+    case 'x':           out.op = IN_RECORD; break;
+    case 'q': case 'Q': out.op = IN_EFFECT; out.arg = FX_CONFETTI; break;
+    case 'w': case 'W': out.op = IN_EFFECT; out.arg = FX_BOUNCE; break;
+    case 'r': case 'R': out.op = IN_EFFECT; out.arg = FX_RAINBOW; break;
+    case 'e': case 'E': out.op = IN_EFFECT; out.arg = FX_SEGMENT_DJ; break;
+    case 'n':           out.op = IN_TAP; out.arg = 0; break;
+    case 'N':           out.op = IN_TAP; out.arg = 0; out.value = +1; break;
+    case 'c': case 'C': out.op = IN_TAP; out.arg = 1; break;
+    case 'f': case 'F': out.op = IN_FLASH_PULSE; break;
+    case 'P':           out.op = IN_STEP_EFFECT; out.value = -1; break;
+    case 'k': case 'K': out.op = IN_JOLT; break;
+    case 'm': case 'M': out.op = IN_TO_MUSIC; break;
+    case 'b':           out.op = IN_PARAM_STEP; out.arg = P_BASS_GATE;   out.value = -1; break;
+    case 'B':           out.op = IN_PARAM_STEP; out.arg = P_BASS_GATE;   out.value = +1; break;
+    case 't':           out.op = IN_PARAM_STEP; out.arg = P_TREBLE_GATE; out.value = -1; break;
+    case 'T':           out.op = IN_PARAM_STEP; out.arg = P_TREBLE_GATE; out.value = +1; break;
+    case 'l':           out.op = IN_LASER_TOGGLE; break;
+    case 'p':           out.op = IN_ARROW_TARGET; break;
+    case 'o': case 'O': out.op = IN_RESTORE_DEFAULTS; break;
+    default:
+      if (c >= '1' && c <= '9') { out.op = IN_PALETTE; out.arg = (uint8_t)(c - '1'); }
+      break;
+  }
+  return true;
+}
+
+// Reads every input source and queues what changed. A command that doesn't
+// fit stays pending (last-sent state isn't updated, serial stays in the
+// UART), so nothing is lost - only late.
+void pollInputs() {
+  pollButtons();
+
+  static int potSent[2] = { -1, -1 };
+  for (uint8_t k = 0; k < 2; k++) {
+    int raw = readPot(k);                      // adcTask's latest on the rig
+    if (raw < 0) continue;                     // not polled yet
+    if (potSent[k] >= 0 && abs(raw - potSent[k]) < POT_MOVE_RAW) continue;
+    if (inputQueue.push({ IN_POT, k, 0, (int16_t)raw })) potSent[k] = raw;
+  }
+
+  static bool touchSent[2] = { false, false };
+  const bool touch[2] = { touchRead(EFFECT_PIN) < touchThreshold, touchRead(FLASH_PIN) < touchThreshold };
+  for (uint8_t k = 0; k < 2; k++)
+    if (touch[k] != touchSent[k] && inputQueue.push({ IN_TOUCH, k, 0, touch[k] }))
+      touchSent[k] = touch[k];
+
+  while (inputQueue.space() > 0 && Serial.available() > 0) {
+    InputCmd in;
+    if (decodeKey((char)Serial.read(), in)) inputQueue.push(in);
+  }
+}
+
+// ---- consumer ----
+static void applyArrow(char dir) {
+  // Right/Left switch target among the arrow modes
+  if (dir == 'C' || dir == 'D') {
+    const uint8_t FIRST = ARROW_STROBE_COLOR;
+    const uint8_t LAST  = ARROW_MODE_COUNT - 1; // ARROW_BRIGHTNESS
+    if (dir == 'C') arrowMode = (arrowMode >= LAST)  ? FIRST : (arrowMode + 1);
+    else            arrowMode = (arrowMode <= FIRST) ? LAST  : (arrowMode - 1);
+    Serial.print("Arrows -> ");
+    Serial.println(PARAMS[ARROW_PARAMS[arrowMode]].name);
+    invalidateHud();
+    return;
+  }
 
+  // Up/Down adjust the current target
+  ParamId id = ARROW_PARAMS[arrowMode];
+  paramStep(id, dir == 'A' ? +1 : -1);
+  paramLog(id);
+}
 
+static void stepEffect(int delta) {
+  currentEffect = (currentEffect + FX_COUNT + delta) % FX_COUNT;
+  currentMode   = FX_MODE;
+  invalidateHud();
+}
 
-void handleInputs() {
-  while (Serial.available() > 0) {
-    char c = Serial.read();
+static void applyInput(const InputCmd& in) {
+  if ((in.flags & INF_WAKES) && blackoutActive) {
+    blackoutActive = false;
+    Serial.println("Blackout cleared");
+  }
 
-    // ===== Arrow-key state machine (ESC [ A/B/C/D) =====
-    if (escState == ESC_IDLE) {
-      if ((uint8_t)c == 0x1B) {  // ESC
-        escState = ESC_SEEN;
-        continue;
-      }
-    } else if (escState == ESC_SEEN) {
-      if (c == '[') { escState = ESC_BRACKET; continue; }
-      else { escState = ESC_IDLE; /* fall through */ }
-    } else if (escState == ESC_BRACKET) {
-      if (c == 'A' || c == 'B' || c == 'C' || c == 'D') {
-        // Right/Left switch target among the arrow modes (now includes FlashColor & Brightness)
-if (c == 'C' || c == 'D') {
-  const uint8_t FIRST = ARROW_STROBE_COLOR;     
-  const uint8_t LAST  = ARROW_MODE_COUNT - 1; // ARROW_BRIGHTNESS
-  if (c == 'C') { // Right
-    arrowMode = (arrowMode >= LAST) ? FIRST : (arrowMode + 1);
-  } else {        // Left
-    arrowMode = (arrowMode <= FIRST) ? LAST : (arrowMode - 1);
-  }
-  Serial.print("Arrows -> ");
-  Serial.println(ARROW_MODE_NAMES[arrowMode]);
-  drawHome();
-  escState = ESC_IDLE;
-  continue;
-}
-
-
-        // Up/Down adjust the current gate
-        bool up = (c == 'A');
-        switch (arrowMode) {
-          case ARROW_MUSIC_GATE:
-            MUSIC_GATE_THRESH  = constrain(MUSIC_GATE_THRESH  + (up ? +ARROW_STEP_THRESH : -ARROW_STEP_THRESH), 0, 900);
-            Serial.printf("MusicGate=%d\n",  MUSIC_GATE_THRESH);
-            break;
-          case ARROW_BASS_GATE:
-            BASS_GATE_THRESH   = constrain(BASS_GATE_THRESH   + (up ? +ARROW_STEP_THRESH : -ARROW_STEP_THRESH),  0, 900);
-            Serial.printf("BassGate=%d\n",   BASS_GATE_THRESH);
-            break;
-          case ARROW_TREBLE_GATE:
-            TREBLE_GATE_THRESH = constrain(TREBLE_GATE_THRESH + (up ? +ARROW_STEP_THRESH : -ARROW_STEP_THRESH), 0, 900);
-            Serial.printf("TrebleGate=%d\n", TREBLE_GATE_THRESH);
-            break;
-          case ARROW_LASER_GATE:   // <-- NEW
-            LASER_GATE_THRESH  = constrain(LASER_GATE_THRESH  + (up ? +ARROW_STEP_THRESH : -ARROW_STEP_THRESH), 0, 900);
-            Serial.printf("LaserGate=%d\n",  LASER_GATE_THRESH);
-            break;
-          case ARROW_FLASH_COLOR: {
-          // Up = previous set, Down = next set (wrap)
-          int next = (int)flashSetIdx + (up ? -1 : +1);
-          if (next < 0) next = FLASH_SET_COUNT - 1;
-          if (next >= FLASH_SET_COUNT) next = 0;
-          flashSetIdx = (uint8_t)next;
-          Serial.printf("FlashColor -> %s (idx=%u)\n", FLASH_SETS[flashSetIdx].name, flashSetIdx);
-          break;
-              }
-          case ARROW_BRIGHTNESS: {
-          // Up/Down nudge global brightness
-          uint8_t cur = FastLED.getBrightness();
-          int v = (int)cur + (up ? +ARROW_STEP_BRIGHT : -ARROW_STEP_BRIGHT);
-          v = constrain(v, BRIGHT_MIN, BRIGHT_MAX);
-          FastLED.setBrightness((uint8_t)v);
-          Serial.printf("Brightness=%d\n", v);
-          break;
-              }
-          case ARROW_STROBE_COLOR: {
-         // Up = previous set, Down = next set (wrap)
-          int next = (int)strobeSetIdx + (up ? -1 : +1);
-          if (next < 0) next = STROBE_SET_COUNT - 1;
-          if (next >= STROBE_SET_COUNT) next = 0;
-          strobeSetIdx = (uint8_t)next;
-          Serial.printf("StrobeColor -> %s (idx=%u)\n", STROBE_SETS[strobeSetIdx].name, strobeSetIdx);
-          break;
-          }
-
-          default:
-            // ignore other modes while pots/buttons are disabled
-            break;
-        }
-        drawHome();
-        escState = ESC_IDLE;
-        continue;
-      } else {
-        escState = ESC_IDLE; // abort sequence
-      }
-    }
+  switch (in.op) {
+    case IN_ARROW: applyArrow((char)in.arg); break;
 
-    // ================================================
+    case IN_ARROW_TARGET:   // cycle Music → Bass → Treble → Laser
+      if      (arrowMode == ARROW_MUSIC_GATE)   arrowMode = ARROW_BASS_GATE;
+      else if (arrowMode == ARROW_BASS_GATE)    arrowMode = ARROW_TREBLE_GATE;
+      else if (arrowMode == ARROW_TREBLE_GATE)  arrowMode = ARROW_LASER_GATE;
+      else                                      arrowMode = ARROW_MUSIC_GATE;   // wrap to start
+      Serial.print("Arrows -> ");
+      Serial.println(PARAMS[ARROW_PARAMS[arrowMode]].name);
+      invalidateHud();
+      break;
 
-    // ---- Auto palette cycle toggle (Music mode) ----
-    if (c == 'a' || c == 'A') {
+    case IN_AUTO_CYCLE:
       if (currentMode != MUSIC_MODE) currentMode = MUSIC_MODE;
       autoCyclePal     = !autoCyclePal;
-      nextPaletteCycle = millis() + PALETTE_CYCLE_MS;
+      nextPaletteCycle = frameClock.ms() + PALETTE_CYCLE_MS;
       Serial.printf("Auto palette cycle %s (every %lus)\n",
-                    autoCyclePal ? "ON" : "OFF", PALETTE_CYCLE_MS/1000);
-      drawHome();
-      continue;
-    }
+                    autoCyclePal ? "ON" : "OFF", (unsigned long)(PALETTE_CYCLE_MS / 1000));
+      invalidateHud();
+      break;
 
-    if (c == 'Z') { dumpIOOnce(); continue; }
+    case IN_DUMP_IO: dumpIOOnce(); break;
 
-    // ---- Blackout 'd' ----
-    if (c == 'd') {
+    case IN_BLACKOUT:
       blackoutActive = true;
       Serial.println("Blackout: fade to black (press any key to resume)");
-      continue;
-    }
-    if (blackoutActive) {
-      blackoutActive = false;
-      Serial.println("Blackout cleared");
-      // fall through to handle this key normally
-    }
+      break;
 
-    // ---- Keyboard strobe 's' (toggle) ----
-    if (c == 's' || c == 'S') {
+    case IN_STROBE_KEY:
       strobeFromKey = !strobeFromKey;
       Serial.printf("Strobe (keyboard) %s\n", strobeFromKey ? "ON" : "OFF");
-      continue;
-    }
+      break;
 
-    // ---- Palette keys (1..9) ----
-    if (c >= '1' && c <= '9') {
-      uint8_t pidx = (uint8_t)(c - '1'); // 0..8
-      if (pidx < MUSIC_PALETTE_COUNT) {
-        if (currentMode == FX_MODE &&
-            (currentEffect == FX_SEGMENT_DJ || currentEffect == FX_BOUNCE)) {
-          setMusicPalette(pidx);
-        } else {
+    case IN_PALETTE:
+      if (in.arg < MUSIC_PALETTE_COUNT) {
+        // DJ and Bounce keep running with the new palette; anything else goes to Music
+        if (!(currentMode == FX_MODE && (currentEffect == FX_SEGMENT_DJ || currentEffect == FX_BOUNCE)))
           currentMode = MUSIC_MODE;
-          setMusicPalette(pidx);
-        }
+        paramSet(P_PALETTE, in.arg);
       }
-      continue;
-    }
+      break;
 
-    if (c == 'g' || c == 'G') {
-      debugBands = !debugBands;
-      Serial.printf("MSGEQ7 serial debug %s\n", debugBands ? "ON" : "OFF");
-      if (debugBands) { printBandsLine(); printBandsBars(); }
-      return;
+    case IN_BUDGET_REPORT: {
+      budgetReport = (BudgetReport)((budgetReport + 1) % 3);
+      static const char* const BR_NAMES[] = { "OFF", "summary (1 Hz)", "trace (BT + BR CSV per frame)" };
+      Serial.printf("Frame budget report %s\n", BR_NAMES[budgetReport]);
+      break;
     }
 
-    // ---- Explicit FX keys ----
-    if (c == 'q' || c == 'Q') { currentMode = FX_MODE; currentEffect = FX_CONFETTI;  Serial.println("Effect -> Confetti"); drawHome(); continue; }
-    if (c == 'w' || c == 'W') { currentMode = FX_MODE; currentEffect = FX_BOUNCE;    Serial.println("Effect -> Bounce");   drawHome(); continue; }
-    if (c == 'r' || c == 'R') { currentMode = FX_MODE; currentEffect = FX_RAINBOW;   Serial.println("Effect -> Rainbow");  drawHome(); continue; }
-    if (c == 'e' || c == 'E') { currentMode = FX_MODE; currentEffect = FX_SEGMENT_DJ;Serial.println("Effect -> DJ Segments"); drawHome(); continue; }
-
-    // ---- Live taps only when DJ Segments is active ----
-    if (currentMode == FX_MODE && currentEffect == FX_SEGMENT_DJ) {
-      if (c == 'n' || c == 'N') { spawnSegment(bassCursor, BASS_SEG_LEN, true);  bassCursor  = (bassCursor  + BASS_STEP) % NUM_LEDS; continue; }
-      if (c == 'c' || c == 'C') { spawnSegment(trebleCursor - TREB_SEG_LEN + 1, TREB_SEG_LEN, false); trebleCursor = (trebleCursor - TREBLE_STEP + NUM_LEDS) % NUM_LEDS; continue; }
-    }
+    case IN_TARGET_FPS:
+      TARGET_FPS = (uint8_t)constrain((int)TARGET_FPS + in.value, 20, 120);
+      frameBudget.setTargetFps(TARGET_FPS);
+      Serial.printf("Target FPS=%u (budget %luus)\n", TARGET_FPS, (unsigned long)frameBudget.periodUs());
+      break;
+
+    case IN_TELEMETRY:
+      telemetryOn = !telemetryOn;
+      Serial.printf("Telemetry stream %s\n", telemetryOn ? "ON" : "OFF");
+      break;
+
+    case IN_PRINT_BANDS: printBandsLine(); printBandsBars(); break;
+
+    case IN_RECORD:
+      recordOn = !recordOn;
+      Serial.printf("Record raw bands %s\n", recordOn ? "ON" : "OFF");
+      break;
+
+    case IN_EFFECT:
+      if (in.arg >= FX_COUNT) break;
+      currentMode   = FX_MODE;
+      currentEffect = in.arg;
+      Serial.printf("Effect -> %s\n", FX[currentEffect].name);
+      invalidateHud();
+      break;
+
+    case IN_TAP:
+      // Live taps only when DJ Segments is active
+      if (currentMode == FX_MODE && currentEffect == FX_SEGMENT_DJ) {
+        if (in.arg == 0) { spawnSegment(bassCursor, BASS_SEG_LEN, true);  bassCursor  = (bassCursor  + BASS_STEP) % NUM_LEDS; }
+        else { spawnSegment(trebleCursor - TREB_SEG_LEN + 1, TREB_SEG_LEN, false); trebleCursor = (trebleCursor - TREBLE_STEP + NUM_LEDS) % NUM_LEDS; }
+      } else if (in.value) {
+        stepEffect(in.value);
+      }
+      break;
 
-    // ---- Momentary flash ----
-    if (c == 'f' || c == 'F') { flashPulseUntil = millis() + FLASH_PULSE_MS; continue; }
+    case IN_STEP_EFFECT: stepEffect(in.value); break;
 
-    // ---- FX next/prev ----
-    if (c == 'P') { currentEffect = (currentEffect + FX_COUNT - 1) % FX_COUNT; currentMode = FX_MODE; drawHome(); continue; }
-    if (c == 'N') { currentEffect = (currentEffect + 1) % FX_COUNT;            currentMode = FX_MODE; drawHome(); continue; }
+    case IN_FLASH_PULSE: flashPulseUntil = frameClock.ms() + FLASH_PULSE_MS; break;
 
-    // ---- Bounce jolt ----
-    if ((c == 'k' || c == 'K') && currentMode == FX_MODE && currentEffect == FX_BOUNCE) {
-      uint32_t now = millis();
+    case IN_JOLT: {
+      if (!(currentMode == FX_MODE && currentEffect == FX_BOUNCE)) break;
+      uint32_t now = frameClock.ms();
       auto stack_to = [&](uint32_t &deadline){
         uint32_t leftover = (deadline > now) ? (deadline - now) : 0;
         deadline = now + min<uint32_t>(1400, leftover + BOUNCE_JOLT_MS);
@@ -1789,56 +2632,59 @@ if (c == 'C' || c == 'D') {
       spawnStaticPulse(true,  h1, true);  spawnStaticPulse(true,  h1, false);
       spawnStaticPulse(false, h2, false); spawnStaticPulse(false, h2, true);
       Serial.println("Bounce JOLT + OUTWARD STATIC!");
-      continue;
-    }
-
-    // ---- Back to Music from DJ/Bounce ----
-    if ((c == 'm' || c == 'M') &&
-        currentMode == FX_MODE &&
-        (currentEffect == FX_SEGMENT_DJ || currentEffect == FX_BOUNCE)) {
-      currentMode = MUSIC_MODE; Serial.println("Mode -> Music (keeping current palette)"); drawHome(); continue;
+      break;
     }
 
-    // ---- Direct gate nudges (b/B, t/T) ----
-    if (c == 'b') { BASS_GATE_THRESH   = max(0,   BASS_GATE_THRESH   - 10); Serial.print("BassThresh=");   Serial.println(BASS_GATE_THRESH);   continue; }
-    if (c == 'B') { BASS_GATE_THRESH   = min(900, BASS_GATE_THRESH   + 10); Serial.print("BassThresh=");   Serial.println(BASS_GATE_THRESH);   continue; }
-    if (c == 't') { TREBLE_GATE_THRESH = max(0,   TREBLE_GATE_THRESH - 10); Serial.print("TrebleThresh="); Serial.println(TREBLE_GATE_THRESH); continue; }
-    if (c == 'T') { TREBLE_GATE_THRESH = min(900, TREBLE_GATE_THRESH + 10); Serial.print("TrebleThresh="); Serial.println(TREBLE_GATE_THRESH); continue; }
+    case IN_TO_MUSIC:   // back to Music from DJ/Bounce
+      if (currentMode == FX_MODE && (currentEffect == FX_SEGMENT_DJ || currentEffect == FX_BOUNCE)) {
+        currentMode = MUSIC_MODE;
+        Serial.println("Mode -> Music (keeping current palette)");
+        invalidateHud();
+      }
+      break;
+
+    case IN_PARAM_STEP:
+      if (in.arg >= P_COUNT) break;
+      paramStep((ParamId)in.arg, in.value);
+      paramLog((ParamId)in.arg);
+      break;
+
+    case IN_LASER_TOGGLE: setLaserLatched(!laserOn); break;
+
+    case IN_RESTORE_DEFAULTS:
+      paramSet(P_FLASH_SET,   DEFAULT_FLASHSET);
+      paramSet(P_MUSIC_GATE,  DEFAULT_MUSIC_GATE);
+      paramSet(P_BASS_GATE,   DEFAULT_BASS_GATE);
+      paramSet(P_TREBLE_GATE, DEFAULT_TREBLE_GATE);
+      paramSet(P_BRIGHTNESS,  DEFAULT_BRIGHTNESS);
+      Serial.println("Restored defaults: flash color, gates, brightness.");
+      invalidateHud();
+      break;
 
-    // ---- Lasers ----
-    if (c == 'l' || c == 'L') {
-  if (c == 'L') { /* strobe burst handled elsewhere */ continue; }
-  setLaserLatched(!laserOn);
-  continue;
-}
+    case IN_BUTTON:
+      if (in.arg >= 8) break;
+      BTN[in.arg].pressed = in.value != 0;
+      if (in.value) BTN[in.arg].fellEdge = true; else BTN[in.arg].roseEdge = true;
+      break;
 
+    case IN_POT:
+      if (in.arg < 2) potRaw[in.arg] = constrain((int)in.value, 0, 4095);
+      break;
 
+    case IN_TOUCH:
+      if (in.arg == 0) strobeActive = in.value != 0; else flashHeldTouch = in.value != 0;
+      break;
 
-    // ---- Rotate arrow target: 'p' (cycle Music → Bass → Treble → Laser) ----
-if (c == 'p' || c == 'P') {
-  if      (arrowMode == ARROW_MUSIC_GATE)   arrowMode = ARROW_BASS_GATE;
-  else if (arrowMode == ARROW_BASS_GATE)    arrowMode = ARROW_TREBLE_GATE;
-  else if (arrowMode == ARROW_TREBLE_GATE)  arrowMode = ARROW_LASER_GATE;   // <-- NEW hop
-  else                                      arrowMode = ARROW_MUSIC_GATE;   // wrap to start
-  Serial.print("Arrows -> ");
-  Serial.println(ARROW_MODE_NAMES[arrowMode]);
-  drawHome();
-  continue;
+    default: break;
+  }
 }
 
-    // ---- Restore defaults: 'o' ----
-    if (c == 'o' || c == 'O') {
-      flashSetIdx        = DEFAULT_FLASHSET;
-      MUSIC_GATE_THRESH  = DEFAULT_MUSIC_GATE;
-      BASS_GATE_THRESH   = DEFAULT_BASS_GATE;
-      TREBLE_GATE_THRESH = DEFAULT_TREBLE_GATE;
-      FastLED.setBrightness(DEFAULT_BRIGHTNESS);
-      Serial.println("Restored defaults: flash color, gates, brightness.");
-      drawHome();
-      continue;
-    }
-
-  }
+// Frame boundary: button edges last one frame, then everything queued since
+// the last frame is applied in order.
+void applyInputs() {
+  for (uint8_t i = 0; i < 8; i++) BTN[i].fellEdge = BTN[i].roseEdge = false;
+  InputCmd in;
+  while (inputQueue.pop(in)) applyInput(in);
 }
 
 
@@ -1846,10 +2692,10 @@ void spawnStaticPulse(bool onStrip1, int headIdx, bool dirRight) {
   StaticPulse* arr = onStrip1 ? pulses1 : pulses2;
   // find free slot
   for (uint8_t i = 0; i < MAX_PULSES; i++) {
-    if (!arr[i].active) { arr[i] = { headIdx, dirRight, millis(), true }; return; }
+    if (!arr[i].active) { arr[i] = { headIdx, dirRight, frameClock.ms(), true }; return; }
   }
   // overwrite oldest
-  uint8_t oldest = 0; uint32_t oldestAge = 0, now = millis();
+  uint8_t oldest = 0; uint32_t oldestAge = 0, now = frameClock.ms();
   for (uint8_t i = 0; i < MAX_PULSES; i++) {
     uint32_t age = now - arr[i].startMs;
     if (age > oldestAge) { oldestAge = age; oldest = i; }
@@ -1858,7 +2704,8 @@ void spawnStaticPulse(bool onStrip1, int headIdx, bool dirRight) {
 }
 
 void renderStaticPulses(StaticPulse* arr, CRGB* strip) {
-  uint32_t now = millis();
+  uint32_t now = frameClock.ms();
+  const PaletteLut& lut = paletteLut();
   for (uint8_t i = 0; i < MAX_PULSES; i++) {
     if (!arr[i].active) continue;
     uint32_t age = now - arr[i].startMs;
@@ -1875,11 +2722,13 @@ void renderStaticPulses(StaticPulse* arr, CRGB* strip) {
     // fade the whole window out over time
     uint8_t life = 255 - map(age, 0, STATIC_PULSE_MS, 0, 255);
 
-    for (int p = start; p <= end; p++) {
-  if (p < 0 || p >= NUM_LEDS) continue;
+    const int pa = max(start, 0), pb = min(end, NUM_LEDS - 1);
+    const int noiseMask = quality.noiseStep - 1;
+    uint8_t n = 0;
+    for (int p = pa; p <= pb; p++) {
 
-  // Perlin noise base
-  uint8_t n = inoise8(p * 11, age * 8);
+  // Perlin noise base (held across noiseStep px when over budget)
+  if (((p - pa) & noiseMask) == 0) n = inoise8(p * 11, age * 8);
 
   // Derive a sparsity factor from your existing knobs:
   // - lower STATIC_INTENSITY -> fewer specks
@@ -1898,7 +2747,7 @@ void renderStaticPulses(StaticPulse* arr, CRGB* strip) {
   v = scale8(v, life);
 
   // Palette-tinted snow, with occasional brighter specks
-  CRGB c = ColorFromPalette(currentPal, (p * 3 + age) & 0xFF, v);
+  CRGB c = lut.at((p * 3 + age) & 0xFF, v);
   if (speck) nblend(c, CRGB::White, 96); // tasteful pop, not full white
 
   nblend(strip[p], c, v);
@@ -1906,49 +2755,34 @@ void renderStaticPulses(StaticPulse* arr, CRGB* strip) {
   }
 }
 
-// These three are “virtual” knobs that scale existing behaviors:
-uint8_t CLOUD_EDGE_SOFT_KNOB = 50;      // maps to CLOUD_EDGE/softness factor
-uint8_t CLOUD_SPEED_SCALE    = 100;     // 100% = unchanged
-uint8_t SPARKLE_INTENSITY    = 50;      // 0..100 → maps to prob cap
-
-
-// --- D: Overlays/Strobe/Lasers ---
-uint16_t POP_FLASH_MS_K = POP_FLASH_MS, POP_HOLD_MS_K = POP_HOLD_MS, POP_FADE_MS_K = POP_FADE_MS;
-
-
 static void initButtons() {
   const uint8_t pins[8] = {BTN_A,BTN_B,BTN_C,BTN_D,BTN_E,BTN_F,BTN_G,BTN_H};
   for (int i=0;i<8;i++){
     bool hasPullup = !(pins[i]==34 || pins[i]==35 || pins[i]==36 || pins[i]==39);
     pinMode(pins[i], hasPullup ? INPUT_PULLUP : INPUT);
-    BTN[i].pin = pins[i];
-    BTN[i].lastLevel = btnIdleLevel();
-    BTN[i].lastChangeMs = 0;
+    btnDebounce[i] = { pins[i], (bool)btnIdleLevel(), 0, false, false };
     BTN[i].pressed = false;
     BTN[i].fellEdge = BTN[i].roseEdge = false;
   }
 }
 
 
-static void scanButtons() {
-  const uint32_t now = millis();
-  for (int i = 0; i < 8; i++) {
-    bool lvl = digitalRead(BTN[i].pin);
-    BTN[i].fellEdge = BTN[i].roseEdge = false;
+// Producer side: debounce and queue press/release edges.
+static void pollButtons() {
+  const uint32_t now = frameClock.ms();
+  for (uint8_t i = 0; i < 8; i++) {
+    BtnDebounce& b = btnDebounce[i];
+    bool lvl = digitalRead(b.pin);
 
-    if (lvl != BTN[i].lastLevel) {
-      BTN[i].lastLevel = lvl;
-      BTN[i].lastChangeMs = now;
+    if (lvl != b.lastLevel) {
+      b.lastLevel = lvl;
+      b.lastChangeMs = now;
     }
 
     // simple debounce (6–12 ms is usually fine)
-    if (now - BTN[i].lastChangeMs > 12) {
-      bool pressed = BTN_ACTIVE_LOW ? (lvl == LOW) : (lvl == HIGH);
-      if (pressed != BTN[i].pressed) {
-        BTN[i].pressed = pressed;
-        if (pressed) BTN[i].fellEdge = true; else BTN[i].roseEdge = true;
-      }
-    }
+    if (now - b.lastChangeMs > 12) b.pressed = BTN_ACTIVE_LOW ? (lvl == LOW) : (lvl == HIGH);
+    if (b.pressed != b.sent && inputQueue.push({ IN_BUTTON, i, 0, b.pressed }))
+      b.sent = b.pressed;
   }
 }
 
@@ -1956,7 +2790,7 @@ static void scanButtons() {
 
 // ==== QUICK I/O MONITOR (press 'Z') ====
 void dumpIOOnce() {
-  int raw = analogRead(POT1_PIN);
+  int raw = readPot(0);
   int ba = digitalRead(BTN_A), bb = digitalRead(BTN_B),
       bc = digitalRead(BTN_C), bd = digitalRead(BTN_D);
 
@@ -1966,48 +2800,102 @@ void dumpIOOnce() {
 }
 
 
-void drawHome() {
-  if (!displayOK) return;
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0,0);
-  display.println("Visualizer");
+// ============== HUD (home screen) ==============
+// Everything the home screen shows, as one snapshot. Code that changes any of
+// it calls invalidateHud() - a version bump, nothing drawn - as often as it
+// likes. renderHud() is the single render point, once per frame after the
+// inputs: on a new version, or every HUD_POLL_MS for values changed without
+// one (pots, auto palette), it takes a snapshot and composes the screen only
+// if that differs from the last one drawn. Other screens own the panel while
+// they're up; coming back to Home always redraws.
+struct HudState {
+  uint8_t mode, effect, palette, sensPct, potMode;
+  bool    laserOn, laserAuto;
+  int16_t musicGate, bassGate, trebleGate;
 
-  display.print("Mode: ");
-  display.println(currentMode == MUSIC_MODE ? "Music" : "FX");
+  bool operator==(const HudState& o) const {
+    return mode == o.mode && effect == o.effect && palette == o.palette && sensPct == o.sensPct &&
+           potMode == o.potMode && laserOn == o.laserOn && laserAuto == o.laserAuto &&
+           musicGate == o.musicGate && bassGate == o.bassGate && trebleGate == o.trebleGate;
+  }
+};
 
-  if (currentMode == MUSIC_MODE) {
-    display.println("Effect: PaletteFlow");
+static uint32_t hudVersion      = 1;
+static uint32_t hudDrawnVersion = 0;
+static HudState hudDrawn;
+static bool     hudOnPanel      = false;   // hudDrawn is what the panel shows
+static uint32_t hudPolledMs     = 0;
+static uint32_t hudRedraws      = 0;
+const  uint16_t HUD_POLL_MS     = 100;
+
+void invalidateHud() { hudVersion++; }
+
+static HudState snapshotHud() {
+  HudState h;
+  h.mode       = (uint8_t)currentMode;
+  h.effect     = (uint8_t)currentEffect;
+  h.palette    = settings.palette;
+  h.sensPct    = (uint8_t)((uint16_t)settings.gateSensQ8 * 100 / 255);
+  h.potMode    = settings.knobMode;
+  h.laserOn    = laserOn;
+  h.laserAuto  = settings.laserAuto;
+  h.musicGate  = (int16_t)settings.musicGate;
+  h.bassGate   = (int16_t)settings.bassGate;
+  h.trebleGate = (int16_t)settings.trebleGate;
+  return h;
+}
+
+static void drawHome(const HudState& h) {
+  oled.clear();
+  oled.setCursor(0,0);
+  oled.println("Visualizer");
+
+  oled.print("Mode: ");
+  oled.println(h.mode == MUSIC_MODE ? "Music" : "FX");
+
+  if (h.mode == MUSIC_MODE) {
+    oled.println("Effect: PaletteFlow");
   } else {
-    display.print("Effect: ");
-    display.println(FX[currentEffect].name);
+    oled.print("Effect: ");
+    oled.println(FX[h.effect].name);
   }
 
-display.print("Gate M/B/T: ");
-display.print(MUSIC_GATE_THRESH); display.print("/");
-display.print(BASS_GATE_THRESH);  display.print("/");
-display.println(TREBLE_GATE_THRESH);
-display.print("Sens%: ");
-display.println((unsigned)((uint16_t)GATE_SENS_Q8*100/255));
+oled.print("Gate M/B/T: ");
+oled.print(h.musicGate); oled.print("/");
+oled.print(h.bassGate);  oled.print("/");
+oled.println(h.trebleGate);
+oled.print("Sens%: ");
+oled.println((unsigned)h.sensPct);
+
 
+  oled.print("Palette: ");
+  oled.println(musicPaletteNames[h.palette]);
 
-  display.print("Palette: ");
-  display.println(musicPaletteNames[musicPaletteIndex]);
+  oled.print("Laser: ");
+  oled.println(h.laserOn ? "ON" : "OFF");
+oled.print("LaserAuto: ");
+oled.println(h.laserAuto ? "ON" : "OFF");
 
-  display.print("Laser: ");
-  display.println(laserOn ? "ON" : "OFF");
-  // In drawHome(), after "Laser: ON/OFF"
-display.print("LaserAuto: ");
-display.println(LASER_AUTO_ENABLED ? "ON" : "OFF");
 
+  oled.println();
+  oled.println("H:Settings  A:Laser  B/C/D:FX");
+  oled.print("Knobs: ");
+oled.println(h.potMode == PM_BRIGHT_MUSIC ? "Bright+Music" : "Bass+Treble");
 
-  display.println();
-  display.println("H:Settings  A:Laser  B/C/D:FX");
-  display.print("Knobs: ");
-display.println(potMode == PM_BRIGHT_MUSIC ? "Bright+Music" : "Bass+Treble");
-  display.display();
+}
 
+void renderHud() {
+  if (ui != UI_HOME || !displayOK) { hudOnPanel = false; return; }
+  const uint32_t now = frameClock.ms();
+  if (hudOnPanel && hudVersion == hudDrawnVersion && now - hudPolledMs < HUD_POLL_MS) return;
+  hudDrawnVersion = hudVersion;
+  hudPolledMs     = now;
+  HudState h = snapshotHud();
+  if (hudOnPanel && h == hudDrawn) return;
+  hudDrawn   = h;
+  hudOnPanel = true;
+  hudRedraws++;
+  drawHome(h);
 }
 
 static void drawSettingsRoot() {
@@ -2017,145 +2905,112 @@ const char* items[SI_COUNT] = {
   "Laser Auto", "Laser Gate"
 };
 
-display.clearDisplay();
-display.setTextSize(1);
-display.setTextColor(SSD1306_WHITE);
-display.setCursor(0,0);
-display.println("Settings");
+oled.clear();
+oled.setCursor(0,0);
+oled.println("Settings");
 
 for (uint8_t i=0;i<SI_COUNT;i++){
-  if (i==menuCursor) display.print("> "); else display.print("  ");
+  if (i==menuCursor) oled.print("> "); else oled.print("  ");
   if (i == SI_KNOBMODE) {
-    display.print(items[i]); display.print(": ");
-    display.println(potMode == PM_BRIGHT_MUSIC ? "Bright+Music" : "Bass+Treble");
+    char b[12];
+    oled.print(items[i]); oled.print(": ");
+    oled.println(paramFormat(P_KNOB_MODE, paramGet(settings, P_KNOB_MODE), b, sizeof(b)));
   } else if (i == SI_LASER_AUTO) {
-    display.print(items[i]); display.print(": ");
-    display.println(LASER_AUTO_ENABLED ? "ON" : "OFF");
+    char b[12];
+    oled.print(items[i]); oled.print(": ");
+    oled.println(paramFormat(P_LASER_AUTO, paramGet(settings, P_LASER_AUTO), b, sizeof(b)));
   } else if (i == SI_LASER_GATE) {
-    display.print(items[i]); display.print(": ");
-    display.println(LASER_GATE_THRESH);
+    char b[12];
+    oled.print(items[i]); oled.print(": ");
+    oled.println(paramFormat(P_LASER_GATE, paramGet(settings, P_LASER_GATE), b, sizeof(b)));
   } else {
-    display.println(items[i]);
+    oled.println(items[i]);
   }
 }
 
 
-display.setCursor(0,56);
-display.print("E/G:Up/Down  F:Enter  H:Back");
-display.display();
+oled.setCursor(0,56);
+oled.print("E/G:Up/Down  F:Enter  H:Back");
 }
 
 
+// Music Settings rows
+const ParamId MUSIC_MENU[] = { P_MUSIC_GATE, P_BASS_GATE, P_TREBLE_GATE, P_SENSITIVITY };
+const uint8_t MUSIC_MENU_COUNT = sizeof(MUSIC_MENU) / sizeof(MUSIC_MENU[0]);
+
 static void drawSettingsMusic() {
   if (!displayOK) return;
-  const char* items[4] = { "Music Gate", "Bass Gate", "Treble Gate", "Sensitivity%" };
-  int valsInt[3] = {MUSIC_GATE_THRESH, BASS_GATE_THRESH, TREBLE_GATE_THRESH};
-
-  // Convert sensitivity to percent for display (approx)
-  int sensPct = (int)((uint16_t)GATE_SENS_Q8 * 100 / 255);
+  oled.clear();
+  oled.setCursor(0,0);
+  oled.println("Music Settings");
 
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0,0);
-  display.println("Music Settings");
-
-  // rows 0..2: the three gates
-  for (uint8_t i = 0; i < 3; i++) {
-    if (i==musicCursor) display.print("> "); else display.print("  ");
-    display.print(items[i]); display.print(": ");
-    display.println(valsInt[i]);
+  char b[12];
+  for (uint8_t i = 0; i < MUSIC_MENU_COUNT; i++) {
+    const ParamId id = MUSIC_MENU[i];
+    if (i==musicCursor) oled.print("> "); else oled.print("  ");
+    oled.print(PARAMS[id].label); oled.print(": ");
+    oled.println(paramFormat(id, paramGet(settings, id), b, sizeof(b)));
   }
 
-  // row 3: Sensitivity%
-  if (3==musicCursor) display.print("> "); else display.print("  ");
-  display.print(items[3]); display.print(": ");
-  display.print(sensPct); display.println("%");
-
-  display.setCursor(0,56);
-  display.print("E/G:Select  F:Adjust  H:Back");
-  display.display();
+  oled.setCursor(0,56);
+  oled.print("E/G:Select  F:Adjust  H:Back");
 }
 
 
 static void drawParamAdjust(const char* name, const char* hint, const char* valueText) {
   if (!displayOK) return;
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0,0);
-  display.println(name);
-  display.println("---------------------");
-  display.println(valueText);
-  display.setCursor(0,56);
-  display.print(hint); // "Turn knob, F:Apply, H:Back"
-  display.display();
+  oled.clear();
+  oled.setCursor(0,0);
+  oled.println(name);
+  oled.println("---------------------");
+  oled.println(valueText);
+  oled.setCursor(0,56);
+  oled.print(hint); // "Turn knob, F:Apply, H:Back"
+}
+
+// Adjust screen for the active parameter: label, then "Name=value"
+static void drawActiveParam() {
+  char b[12], value[32];
+  snprintf(value, sizeof(value), "%s=%s", PARAMS[activeParam].name,
+           paramFormat(activeParam, paramGet(settings, activeParam), b, sizeof(b)));
+  drawParamAdjust(PARAMS[activeParam].label, "Turn knob, F:Apply, H:Back", value);
 }
 
-static void enterParamAdjust(ParamTarget pt) {
-  activeParam = pt;
+static void enterParamAdjust(ParamId id) {
+  activeParam = id;
   ui = UI_PARAM_ADJUST;
 
   potPickupLocked = true;
   potEntryRaw     = readAdjPot();
   potLastCommitRaw= potEntryRaw;
 
-  uiLastActivityMs = millis();
-
-  // Initial draw
-  char value[32];
-    switch (pt) {
-    case PT_MUSIC_GATE: snprintf(value,sizeof(value),"MusicGate=%d", MUSIC_GATE_THRESH); break;
-    case PT_BASS:       snprintf(value,sizeof(value),"BassGate=%d",  BASS_GATE_THRESH);  break;
-    case PT_TREBLE:     snprintf(value,sizeof(value),"TrebleGate=%d",TREBLE_GATE_THRESH);break;
-    case PT_PALETTE:    snprintf(value,sizeof(value),"Palette=%s",   musicPaletteNames[musicPaletteIndex]); break;
-    case PT_FLASHSET:   snprintf(value,sizeof(value),"Flash=%s",     FLASH_SETS[flashSetIdx].name); break;
-    case PT_LASER_GATE:
-  snprintf(value,sizeof(value),"LaserGate=%d", LASER_GATE_THRESH);
-  drawParamAdjust("Laser Gate", "Turn knob, F:Apply, H:Back", value);
-  return;
-
-
-    case PT_SENSITIVITY: {
-      char pct[8];
-      snprintf(pct, sizeof(pct), "%u%%", (unsigned)((uint16_t)GATE_SENS_Q8*100/255));
-      drawParamAdjust("Sensitivity", "Turn knob, F:Apply, H:Back", pct);
-      return; // <-- important: skip the generic draw below
-    }
-
-    default:            snprintf(value,sizeof(value),"-"); break;
-  }
-
-  // Generic draw for non-sensitivity params:
-  drawParamAdjust(
-    (pt==PT_MUSIC_GATE||pt==PT_BASS||pt==PT_TREBLE) ? "Music Param" :
-    (pt==PT_PALETTE ? "Palette Color" : "Flash Color"),
-    "Turn knob, F:Apply, H:Back",
-    value
-  );
+  uiLastActivityMs = frameClock.ms();
+  drawActiveParam();
 }
 
 static void exitToSettingsMenu() {
-  // Exit adjust → back to the right menu level
-  if (activeParam==PT_MUSIC_GATE || activeParam==PT_BASS || activeParam==PT_TREBLE) {
+  // Exit adjust → back to the menu the parameter lives in
+  bool inMusic = false;
+  for (uint8_t i = 0; i < MUSIC_MENU_COUNT; i++) inMusic |= MUSIC_MENU[i] == activeParam;
+  if (inMusic) {
     ui = UI_SETTINGS_MUSIC;
     drawSettingsMusic();
   } else {
     ui = UI_SETTINGS;
     drawSettingsRoot();
   }
-  activeParam = PT_NONE;
+  activeParam = P_COUNT;
 }
 
 static void tickParamAdjust() {
   // buttons
   if (BTN[BI_H].fellEdge) { // back
-    uiLastActivityMs = millis();
+    uiLastActivityMs = frameClock.ms();
     exitToSettingsMenu();
     return;
   }
   if (BTN[BI_F].fellEdge) { // apply/commit (explicit)
-    uiLastActivityMs = millis();
+    uiLastActivityMs = frameClock.ms();
     // Nothing special to do because we “commit” whenever mapped value changes past pickup.
     // This press simply returns to menu.
     exitToSettingsMenu();
@@ -2166,128 +3021,58 @@ static void tickParamAdjust() {
   int raw = readAdjPot();
   if (potEntryRaw < 0) potEntryRaw = raw;
 
-  bool canWrite = true;
   if (potPickupLocked) {
-    if (abs(raw - potEntryRaw) >= POT_PICKUP_DEAD) {
-      potPickupLocked = false;  // unlocked; next writes are allowed
-    } else {
-      canWrite = false;         // ignore jitter before pickup
-    }
+    if (abs(raw - potEntryRaw) < POT_PICKUP_DEAD) return;   // ignore jitter before pickup
+    potPickupLocked = false;
   }
 
-  if (!canWrite) return;
-
-  auto refreshHUD = [&](const char* name, const char* value){
-    drawParamAdjust(name, "Turn knob, F:Apply, H:Back", value);
-  };
-
-  // Write only when mapped VALUE changes (prevents boundary chatter)
-    char buf[32];
-
-  if (activeParam == PT_MUSIC_GATE || activeParam == PT_BASS || activeParam == PT_TREBLE) {
-    // map 0..4095 → 0..900
-    int mapped = map(raw, 0, 4095, 0, 900);
-    mapped = constrain(mapped, 0, 900);
-
-    int* slot = nullptr;
-    const char* nm = "Music Param";
-    if (activeParam == PT_MUSIC_GATE) { slot = &MUSIC_GATE_THRESH;  nm = "Music Gate"; }
-    if (activeParam == PT_BASS)       { slot = &BASS_GATE_THRESH;   nm = "Bass Gate";  }
-    if (activeParam == PT_TREBLE)     { slot = &TREBLE_GATE_THRESH; nm = "Treble Gate";}
-
-    if (slot && mapped != *slot) {
-      *slot = mapped;
-      uiLastActivityMs = millis();
-      snprintf(buf, sizeof(buf), "%s=%d", nm, *slot);
-      drawParamAdjust(nm, "Turn knob, F:Apply, H:Back", buf);
-    }
-
-  } else if (activeParam == PT_PALETTE) {
-    int idx = map(raw, 0, 4095, 0, (int)MUSIC_PALETTE_COUNT - 1);
-    idx = constrain(idx, 0, (int)MUSIC_PALETTE_COUNT - 1);
-    if (idx != (int)musicPaletteIndex) {
-      setMusicPalette((uint8_t)idx);
-      uiLastActivityMs = millis();
-      snprintf(buf,sizeof(buf),"Palette=%s", musicPaletteNames[musicPaletteIndex]);
-      drawParamAdjust("Palette Color", "Turn knob, F:Apply, H:Back", buf);
-    }
-
-  } else if (activeParam == PT_FLASHSET) {
-    int idx = map(raw, 0, 4095, 0, (int)FLASH_SET_COUNT - 1);
-    idx = constrain(idx, 0, (int)FLASH_SET_COUNT - 1);
-    if (idx != (int)flashSetIdx) {
-      flashSetIdx = (uint8_t)idx;
-      uiLastActivityMs = millis();
-      snprintf(buf,sizeof(buf),"Flash=%s", FLASH_SETS[flashSetIdx].name);
-      drawParamAdjust("Flash Color", "Turn knob, F:Apply, H:Back", buf);
-    }
-
-  } else if (activeParam == PT_SENSITIVITY) {
-    // Map pot to 40..255  (≈16%..100%)
-    uint8_t v = (uint8_t)constrain(map(raw, 0, 4095, 40, 255), 40, 255);
-    if (v != GATE_SENS_Q8) {
-      GATE_SENS_Q8 = v;
-      uiLastActivityMs = millis();
-      unsigned pct = (unsigned)((uint16_t)GATE_SENS_Q8 * 100 / 255);
-      snprintf(buf, sizeof(buf), "Sensitivity=%u%%", pct);
-      drawParamAdjust("Sensitivity", "Turn knob, F:Apply, H:Back", buf);
-    }
-  } else if (activeParam == PT_LASER_GATE) {
-  int mapped = map(raw, 0, 4095, 0, 900);
-  mapped = constrain(mapped, 0, 900);
-  if (mapped != LASER_GATE_THRESH) {
-    LASER_GATE_THRESH = mapped;
-    uiLastActivityMs = millis();
-    char buf[32];
-    snprintf(buf, sizeof(buf), "LaserGate=%d", LASER_GATE_THRESH);
-    drawParamAdjust("Laser Gate", "Turn knob, F:Apply, H:Back", buf);
+  // Write only when the mapped VALUE changes (prevents boundary chatter)
+  if (paramSet(activeParam, paramFromKnob(activeParam, raw))) {
+    uiLastActivityMs = frameClock.ms();
+    drawActiveParam();
   }
 }
 
-}
-
 
 static void goHome() {
   ui = UI_HOME;
-  uiLastActivityMs = millis();
+  uiLastActivityMs = frameClock.ms();
   // reset pot pickup on entering Home
   potPickupRaw = -1;
   potPickup    = true;
-  drawHome();
+  invalidateHud();
 }
 
 
 static void tickSettingsRoot() {
   if (BTN[BI_H].fellEdge) { goHome(); return; }
 
-  if (BTN[BI_E].fellEdge) { if (menuCursor>0) menuCursor--; uiLastActivityMs=millis(); drawSettingsRoot(); }
-  if (BTN[BI_G].fellEdge) { if (menuCursor<SI_COUNT-1) menuCursor++; uiLastActivityMs=millis(); drawSettingsRoot(); }
+  if (BTN[BI_E].fellEdge) { if (menuCursor>0) menuCursor--; uiLastActivityMs=frameClock.ms(); drawSettingsRoot(); }
+  if (BTN[BI_G].fellEdge) { if (menuCursor<SI_COUNT-1) menuCursor++; uiLastActivityMs=frameClock.ms(); drawSettingsRoot(); }
 
   if (BTN[BI_F].fellEdge) {
-  uiLastActivityMs = millis();
+  uiLastActivityMs = frameClock.ms();
 if (menuCursor == SI_MUSIC) {
   ui = UI_SETTINGS_MUSIC; musicCursor=0; drawSettingsMusic();
 
 } else if (menuCursor == SI_PALETTE) {
-  enterParamAdjust(PT_PALETTE);
+  enterParamAdjust(P_PALETTE);
 
 } else if (menuCursor == SI_FLASH) {
-  enterParamAdjust(PT_FLASHSET);
+  enterParamAdjust(P_FLASH_SET);
 
 } else if (menuCursor == SI_KNOBMODE) {
-  potMode = (potMode == PM_BRIGHT_MUSIC) ? PM_BASS_TREBLE : PM_BRIGHT_MUSIC;
-  potA_pickupLocked = potB_pickupLocked = true;
-  potA_entryRaw = potB_entryRaw = -1;
-  Serial.printf("KnobMode -> %s\n", potMode==PM_BRIGHT_MUSIC ? "Bright+Music" : "Bass+Treble");
+  paramStep(P_KNOB_MODE, +1);
+  paramLog(P_KNOB_MODE);
   drawSettingsRoot();
 
 } else if (menuCursor == SI_LASER_AUTO) {
-  LASER_AUTO_ENABLED = !LASER_AUTO_ENABLED;
-  Serial.printf("Laser Auto -> %s\n", LASER_AUTO_ENABLED ? "ON" : "OFF");
+  paramStep(P_LASER_AUTO, +1);
+  paramLog(P_LASER_AUTO);
   drawSettingsRoot();
 
 } else if (menuCursor == SI_LASER_GATE) {
-  enterParamAdjust(PT_LASER_GATE);
+  enterParamAdjust(P_LASER_GATE);
 }
 
 }
@@ -2295,14 +3080,11 @@ if (menuCursor == SI_MUSIC) {
 
 static void tickSettingsMusic() {
   if (BTN[BI_H].fellEdge) { ui = UI_SETTINGS; drawSettingsRoot(); return; }
-  if (BTN[BI_E].fellEdge) { if (musicCursor>0) musicCursor--; uiLastActivityMs=millis(); drawSettingsMusic(); }
-  if (BTN[BI_G].fellEdge) { if (musicCursor<3) musicCursor++; uiLastActivityMs=millis(); drawSettingsMusic(); }
+  if (BTN[BI_E].fellEdge) { if (musicCursor>0) musicCursor--; uiLastActivityMs=frameClock.ms(); drawSettingsMusic(); }
+  if (BTN[BI_G].fellEdge) { if (musicCursor<MUSIC_MENU_COUNT-1) musicCursor++; uiLastActivityMs=frameClock.ms(); drawSettingsMusic(); }
   if (BTN[BI_F].fellEdge) {
-  uiLastActivityMs = millis();
-  if (musicCursor==0) enterParamAdjust(PT_MUSIC_GATE);
-  if (musicCursor==1) enterParamAdjust(PT_BASS);
-  if (musicCursor==2) enterParamAdjust(PT_TREBLE);
-  if (musicCursor==3) enterParamAdjust(PT_SENSITIVITY);  // NEW
+  uiLastActivityMs = frameClock.ms();
+  enterParamAdjust(MUSIC_MENU[musicCursor]);
 }
 }
 
@@ -2312,29 +3094,24 @@ static void tickHome() {
   if (BTN[BI_H].fellEdge) {
     ui = UI_SETTINGS;
     menuCursor = 0;
-    uiLastActivityMs = millis();
+    uiLastActivityMs = frameClock.ms();
     drawSettingsRoot();
     return;
   }
 
   // H hold (>700ms) → panic back to Music mode
   static uint32_t hPressStart = 0;
-  if (BTN[BI_H].fellEdge)   hPressStart = millis();
-  if (BTN[BI_H].pressed && (millis() - hPressStart) > 700) {
+  if (BTN[BI_H].fellEdge)   hPressStart = frameClock.ms();
+  if (BTN[BI_H].pressed && (frameClock.ms() - hPressStart) > 700) {
     currentMode = MUSIC_MODE;
-    uiLastActivityMs = millis();
-    drawHome();
+    uiLastActivityMs = frameClock.ms();
+    invalidateHud();
   }
 
   // --- On Home, E/G cycle palette ---
   if (BTN[BI_E].fellEdge || BTN[BI_G].fellEdge) {
-    int delta = BTN[BI_E].fellEdge ? -1 : +1;  // E = Up/prev, G = Down/next
-    int next  = (int)musicPaletteIndex + delta;
-    if (next < 0) next = MUSIC_PALETTE_COUNT - 1;
-    if (next >= MUSIC_PALETTE_COUNT) next = 0;
-    setMusicPalette((uint8_t)next);           // smooth blend
-    uiLastActivityMs = millis();
-    drawHome();                               // refresh HUD
+    paramStep(P_PALETTE, BTN[BI_E].fellEdge ? -1 : +1);   // E = prev, G = next; smooth blend
+    uiLastActivityMs = frameClock.ms();
     return;
   }
 
@@ -2342,26 +3119,26 @@ static void tickHome() {
   if (BTN[BI_B].fellEdge) {
     currentMode = FX_MODE;
     currentEffect = FX_CONFETTI;
-    uiLastActivityMs = millis();
-    drawHome();
+    uiLastActivityMs = frameClock.ms();
+    invalidateHud();
   }
   if (BTN[BI_C].fellEdge) {
     currentMode = FX_MODE;
     currentEffect = FX_BOUNCE;
-    uiLastActivityMs = millis();
-    drawHome();
+    uiLastActivityMs = frameClock.ms();
+    invalidateHud();
   }
   if (BTN[BI_D].fellEdge) {
     currentMode = FX_MODE;
     currentEffect = FX_SEGMENT_DJ;
-    uiLastActivityMs = millis();
-    drawHome();
+    uiLastActivityMs = frameClock.ms();
+    invalidateHud();
   }
 
   // F enters FX tweak when in FX mode
   if (BTN[BI_F].fellEdge && currentMode == FX_MODE) {
     ui = UI_FX_TWEAK;
-    uiLastActivityMs = millis();
+    uiLastActivityMs = frameClock.ms();
     potPickupRaw = -1;
     potPickup    = true;
     drawFxTweakScreen();
@@ -2376,7 +3153,7 @@ static void tickFxTweak() {
 
 if (currentEffect == FX_BOUNCE && BTN[BI_F].fellEdge) {
   bouncePotTargetsLen = !bouncePotTargetsLen;
-  uiLastActivityMs = millis();
+  uiLastActivityMs = frameClock.ms();
   drawFxTweakScreen();
   Serial.printf("Bounce pot -> %s\n", bouncePotTargetsLen ? "Length" : "Speed");
 }
@@ -2387,23 +3164,20 @@ if (currentEffect == FX_BOUNCE && BTN[BI_F].fellEdge) {
 static void drawFxTweakScreen() {
   if (!displayOK) return;
 
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0,0);
-  display.println("FX Tweak");
-  display.print("Effect: ");
-  display.println(FX[currentEffect].name);
+  oled.clear();
+  oled.setCursor(0,0);
+  oled.println("FX Tweak");
+  oled.print("Effect: ");
+  oled.println(FX[currentEffect].name);
 
   if (currentEffect == FX_BOUNCE) {
-    display.print("Pot: ");
-    display.println(bouncePotTargetsLen ? "Length" : "Speed");
+    oled.print("Pot: ");
+    oled.println(bouncePotTargetsLen ? "Length" : "Speed");
   } else if (currentEffect == FX_CONFETTI) {
-    display.println("Pot: Brightness");
+    oled.println("Pot: Brightness");
   }
 
-  display.println("H:Back");
-  display.display();
+  oled.println("H:Back");
 }
 
 
@@ -2411,19 +3185,18 @@ static void drawFxTweakScreen() {
 // CALL THIS ONCE in setup()
 void initNewUI() {
   initButtons();
-  uiLastActivityMs = millis();
+  uiLastActivityMs = frameClock.ms();
   goHome();
 }
 
 // CALL THIS EACH FRAME in loop()
 void uiTick() {
-  scanButtons();
 if (BTN[BI_A].fellEdge) {
   setLaserLatched(!laserOn);
 }
 
   // 6s inactivity (no button edges & no committed pot changes)
-  if ((millis() - uiLastActivityMs) > UI_IDLE_MS && ui != UI_HOME) {
+  if ((frameClock.ms() - uiLastActivityMs) > UI_IDLE_MS && ui != UI_HOME) {
     goHome();
     return;
   }